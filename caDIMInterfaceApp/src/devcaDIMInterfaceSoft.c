@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #include "alarm.h"
 #include "cvtTable.h"
@@ -19,11 +20,21 @@
 #include "devSup.h"
 #include "link.h"
 #include "dbLock.h"
+#include "callback.h"
 #include "aiRecord.h"
 #include "aoRecord.h"
+#include "waveformRecord.h"
+#include "menuFtype.h"
 #include "assert.h"
 
 #include "epicsExport.h"
+#include "epicsEvent.h"
+#include "epicsMutex.h"
+#include "epicsThread.h"
+#include "gpHash.h"
+#include "iocsh.h"
+#include "dbStaticLib.h"
+#include "epicsExit.h"
 
 /*DIM specific */
 #include "dis.h"
@@ -41,16 +52,20 @@
 /*Dim_call_back is the user routine for a subscribed service as well
  * as for a received command at the moment.*/
 void dimCallback();
+void dimCommandCallback();
 
-/*To compare data to noLink in callback, data has to be cast to the same datatype as nolink.
- * By chance, it is always possible to have exactly the same data content as the content
- * specified by nolink, though.*/
+/*Fill address of dic_info_service(): DIM passes it to the callback if the service
+ * is not available. Recognised by its address only, a regular update carrying
+ * the same bytes is not mistaken for it and its data is not read at all.*/
 
 #define DIMNOLINK "NO LINK!!!"
-char *nolink = NULL;
+static const char nolink[] = DIMNOLINK;
+#define IS_NOLINK(data) ((const char*) (data) == nolink)
 
 /*DIM declarations*/
 #define MAX_DIMRecords 1000
+#define MAX_DIMFormatCacheEntries 1000
+#define MAXIMUMDIMFORMATLENGTH 10000
 #define MAXIMUMDIMDNSADDRESSLENGTH 254 /* see utilities.c */
 
 /*
@@ -62,15 +77,55 @@ static bool dimClientDnsAddressSet = false;
 static bool dimServerDnsPortSet = false;
 static bool dimClientDnsPortSet = false;
 static char* serverName = NULL;
+static int numberOfServerRecords = 0;
+
+/* configuration strings and format arrays of all records, released at exit */
+static struct arena recordArena = {NULL, NULL, 0, 0, 0};
+/* recordVariables of all records in one block, sized at init(after=0) */
+static struct recordVariables* recordPool = NULL;
+static int recordPoolSize = 0;
+static int recordPoolUsed = 0;
+/* strings shared by many records (formats, prefixes, DNS nodes), stored once in recordArena */
+static void* internTable = NULL;
+static unsigned long internedStrings = 0;
+static unsigned long internedReferences = 0;
+static unsigned long internedBytesSaved = 0;
+
+/* format cache: "service@node" -> format, file set by dimSetFormatCache */
+static char* formatCacheFile = NULL;
+static void* formatCacheTable = NULL;
+static struct formatCacheEntry** formatCacheEntries = NULL;
+static int formatCacheIndex = 0;
+/* client services, shared by all records of the same service and scan settings, subscribed in init(after=1) */
+static void* subscriptionTable = NULL;
+static struct dimSubscription** subscriptions = NULL;
+static int numberOfSubscriptions = 0;
+/* served records publishing as one struct service (@Sg), registered in init(after=1) */
+static void* serviceGroupTable = NULL;
+static struct dimServiceGroup** serviceGroups = NULL;
+static int numberOfServiceGroups = 0;
+/* client DNS node before any record changed it (s. setDnsAddress()), key of records without @D */
+static char dimClientDefaultNode[MAXIMUMDIMDNSADDRESSLENGTH+1] = {'\0'};
+static bool dimClientDefaultNodeKnown = false;
+/* output per record at init_record(), iocsh: var dimVerbosity <0|1|2>
+ * 0: none, 1: one line (s. dumpRecordSummary()), 2: all fields (s. dumpStruct()) */
+int dimVerbosity = 1;
+epicsExportAddress(int, dimVerbosity);
 /*  Integrate variables belonging together in a struct, put each struct in an array.*/
 static struct recordVariables** recordVariablesArray = NULL;
 
 /*variables for a command callback routine, currently in development/test stage*/
 void serverCmndCallback();
+void dimServiceRoutine(long *tag, int **address, int *size);
+void swapServiceBuffers(struct recordVariables *thisRecord);
 void getDimFormatCallback(long *tag,  void *data,  int *size);
+void dimSubscriptionCallback(long *tag, int *data, int *size);
+void dimServiceGroupRoutine(long *tag, int **address, int *size);
 
 static long report();
+static long init();
 static long init_record();
+static long get_ioint_info();
 static long process();
 struct
 {
@@ -85,22 +140,166 @@ struct
 devcaDIMInterfaceSoft = {
                            6,
                            report,
-                           NULL,
+                           init,
                            init_record,
-                           NULL,
+                           get_ioint_info,
                            process,
                            NULL
                         };
 
 epicsExportAddress(dset,devcaDIMInterfaceSoft);
 
+/* driver statistics as records (s. DIMInterfaceStatisticsNames) */
+static long statisticsInitRecord();
+static long statisticsRead();
+struct
+{
+   long		number;
+   DEVSUPFUN	report;
+   DEVSUPFUN	init;
+   DEVSUPFUN	init_record;
+   DEVSUPFUN	get_ioint_info;
+   DEVSUPFUN	read_ai;
+   DEVSUPFUN	special_linconv;
+}
+devcaDIMInterfaceStatistics={
+                               6,
+                               NULL,
+                               NULL,
+                               statisticsInitRecord,
+                               NULL,
+                               statisticsRead,
+                               NULL
+                            };
+
+epicsExportAddress(dset,devcaDIMInterfaceStatistics);
+
+/* sums of all records' counters at the last update and the values derived */
+static epicsMutexId statisticsLock = NULL;
+static unsigned long long statisticsTime = 0;
+static struct dimStatistics statisticsPrevious;
+static double statisticsValues[DIMStatisticsLastDummyEntry];
+
 /*report is not necessary, just implemented for testing purposes*/
 static long report (int level)
 {
+   int i=0;
    message(stdout,NULL,0,NULL,NULL,"Report; Number of DIM Records: %i \n", recordIndex);
+   if (0 < level)
+   {
+      message(stdout,NULL,0,NULL,NULL,"\tconfiguration: %lu bytes in %lu allocations\n",
+              (unsigned long) recordArena.allocated, (unsigned long) recordArena.allocations);
+      if (1 < level)
+      {
+         reportStatisticsBy(level, false);
+         reportStatisticsBy(level, true);
+      }
+      for (i=0; i < numberOfSubscriptions; i++)
+      {
+         message(stdout,NULL,0,NULL,NULL,"\tservice `%s': %i record(s) on one subscription, %lu update(s)%s\n",
+                 subscriptions[i]->serviceName, subscriptions[i]->numberOfSubscribers, subscriptions[i]->updates,
+                 subscriptions[i]->serviceOk ? "" : " (not available)");
+      }
+      for (i=0; i < numberOfServiceGroups; i++)
+      {
+         message(stdout,NULL,0,NULL,NULL,"\tservice group `%s': %i record(s), %u bytes, %lu update(s)%s\n",
+                 serviceGroups[i]->name, serviceGroups[i]->numberOfMembers, serviceGroups[i]->size,
+                 serviceGroups[i]->updates, serviceGroups[i]->period ? " (periodic)" : "");
+      }
+      message(stdout,NULL,0,NULL,NULL,"\tinterned strings: %lu for %lu references, %lu bytes saved (%.1f per record)\n",
+              internedStrings, internedReferences, internedBytesSaved,
+              recordIndex ? (double) internedBytesSaved / recordIndex : 0.);
+      for (i=0; i < recordIndex; i++)
+      {
+         struct recordVariables *rec = recordVariablesArray[i];
+         if (NULL != rec && 2 < level)
+         {
+            struct dimStatistics statistics;
+
+            memset(&statistics, 0, sizeof(statistics));
+            statistics.name = ((struct dbCommon*)rec->recordAddress)->name;
+            addStatistics(&statistics, rec);
+            reportStatistics(&statistics, level);
+         }
+         if (NULL == rec || (0 == rec->counters->updatesMerged && 0 == rec->counters->updatesDropped && 0 == rec->counters->commandsFailed))
+         {
+            continue;
+         }
+         message(stdout,NULL,0,NULL,NULL,"\t`%s': updates merged: %lu, dropped: %lu%s, failed commands: %lu\n",
+                 ((struct dbCommon*)rec->recordAddress)->name,
+                 rec->counters->updatesMerged, rec->counters->updatesDropped,
+                 rec->coalesceUpdates ? " (coalescing)" : "",
+                 rec->counters->commandsFailed);
+      }
+   }
    return (0);
 }
 
+static long init(int after)
+{
+   /*
+    * called before (after=0) and after (after=1) the initialisation of the records,
+    * once for each record type using this device support:
+    * all services and commands added in init_record() are served
+    * with a single dis_start_serving(), i.e. one registration at the DIM DNS
+    */
+   static bool dimServing = false;
+   static bool dimSubscribed = false;
+
+   static bool formatCacheRefreshing = false;
+   static bool formatsPreResolved = false;
+   static bool messageLoggerStarted = false;
+
+   /* messages from the DIM and callback threads: queued, printed by a writer thread */
+   if (0 == after && false == messageLoggerStarted)
+   {
+      messageLoggerStarted = true;
+      if (true == startMessageLogger(DIMMESSAGESLOTS))
+      {
+         epicsAtExit(releaseMessageLogger, NULL);
+      }
+   }
+
+   /* format lookups of all client records at once, before init_record() */
+   if (0 == after && false == formatsPreResolved)
+   {
+      formatsPreResolved = true;
+      int numberOfRecords = preResolveFormats();
+      initRecordArena(numberOfRecords);
+      initRecordPool(numberOfRecords);
+   }
+
+   if (1 == after && false == dimServing && NULL != serverName)
+   {
+      /* service groups: all members known, one struct service each */
+      startServiceGroups();
+      dis_start_serving( serverName );
+      dimServing = true;
+      message(stdout,NULL,0,"INFO","init", "DIM server `%s' started serving %i record(s)\n",
+              serverName, numberOfServerRecords);
+   }
+
+   /* client services: all subscribers known, subscribe once each */
+   if (1 == after && false == dimSubscribed)
+   {
+      dimSubscribed = true;
+      startSubscriptions();
+   }
+
+   /* format cache: store and refresh in the background, the records are initialised */
+   if (1 == after && false == formatCacheRefreshing && NULL != formatCacheFile)
+   {
+      formatCacheRefreshing = true;
+      if (NULL == epicsThreadCreate("dimFormatCache", epicsThreadPriorityLow,
+                                    epicsThreadGetStackSize(epicsThreadStackSmall),
+                                    refreshFormatCache, NULL))
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","init", "could not create format cache refresh thread\n");
+      }
+   }
+   return 0;
+}
+
 static long init_record(struct dbCommon	*pRecord)
 {
    /*
@@ -125,6 +324,9 @@ static long init_record(struct dbCommon	*pRecord)
          pRecord->udf = FALSE;
       }
       break;
+   case DIMwaveformRecord:
+      /* array is allocated by the record support, bptr */
+      break;
    default:
       {
          return errorDeactivateRecord(pRecord, __LINE__, "init_record",
@@ -133,22 +335,6 @@ static long init_record(struct dbCommon	*pRecord)
       break;
    }
 
-   /* definition of the nolink option for callback functions */
-   if (NULL == nolink)
-   {
-      nolink = (char*) calloc(10000,sizeof(char));
-      if (NULL == nolink)
-      {
-         return errorDeactivateRecord(pRecord, __LINE__, "init_record","couldn't (re)allocate memory for 'nolink' string");
-      }
-      snprintf(nolink, 10000, "%s%s:%s %s",DIMNOLINK,__FILE__,__DATE__,__TIME__);
-      nolink = (char*) realloc(nolink, (strlen(nolink)+1)*sizeof(char));
-      if (NULL == nolink)
-      {
-         return errorDeactivateRecord(pRecord, __LINE__, "init_record","couldn't (re)allocate memory for 'nolink' string");
-      }
-   }
-
    /*
     * dynamic memory allocation,
     *  i.e. reallocate memory for control structures 
@@ -163,7 +349,7 @@ static long init_record(struct dbCommon	*pRecord)
       }
       assert(NULL != recordVariablesArray);
       /* clear new allocated part*/
-      memset(&recordVariablesArray[recordIndex],0,MAX_DIMRecords);
+      memset(&recordVariablesArray[recordIndex],0,sizeof(struct recordVariables*) * MAX_DIMRecords);
    }
 
    /*
@@ -193,6 +379,22 @@ static long init_record(struct dbCommon	*pRecord)
    }
    assert(NULL != thisRecord);
 
+   /*
+    * bind the control structure to the record,
+    * so process() finds it via dpvt without searching recordVariablesArray
+    */
+   pRecord->dpvt = thisRecord;
+
+   /*
+    * resolve the conversion DIM <-> EPICS once,
+    * process() only calls the kernels
+    */
+   if (false == resolveConversionKernels(thisRecord))
+   {
+      return errorDeactivateRecord(pRecord, __LINE__, "init_record","no conversion for record type `%s' and DIM data type",
+                                   pRecord->rdes->name);
+   }
+
    /*
     * DNS settings
     */
@@ -246,20 +448,18 @@ static long init_record(struct dbCommon	*pRecord)
       /* A.1. connecting to a service service */
       if( true == thisRecord->dimServiceExists )
       {
+         /* I/O Intr scanning: service updates request processing via scanIoRequest() */
+         scanIoInit(&thisRecord->ioScanPvt);
+
          /* connect to service server */
          /* - asserts */
-         assert(NULL != thisRecord->dimServiceName);
+         assert(NULL != thisRecord->config->dimServiceName);
 
-         thisRecord->dimServiceServiceID =
-            dic_info_service(thisRecord->dimServiceName,
-                             thisRecord->dimServiceScanType,
-                             thisRecord->dimServiceScanInterval,
-                             0, 0, dimCallback, recordIndex, &nolink, strlen(nolink)*sizeof(char) );
-         /* check for failure */
-         if ( 1 > thisRecord->dimServiceServiceID )
+         /* one subscription for all records of the same service and scan settings, s. init(after=1) */
+         if (NULL == subscribeService(thisRecord))
          {
             return errorDeactivateRecord(pRecord, __LINE__, "init_record",
-                                         "could not connect to service server `%s' as client", thisRecord->dimServiceName);
+                                         "could not subscribe to service `%s' as client", thisRecord->config->dimServiceName);
          }
       }
    }
@@ -279,42 +479,60 @@ static long init_record(struct dbCommon	*pRecord)
             return errorDeactivateRecord(pRecord, __LINE__, "init_record",
                                          "copyEpicsToDimData() failed\n");
          }
+         swapServiceBuffers(thisRecord);
 
          /*register DIM service service */
          /* - asserts */
          assert(0 != thisRecord->dataSize);
-         assert(NULL != thisRecord->dimServiceName);
-         assert(NULL != thisRecord->dimServiceFormat);
+         assert(NULL != thisRecord->config->dimServiceName);
+         assert(NULL != thisRecord->config->dimServiceFormat);
          assert(NULL != thisRecord->dimData);
 
-         thisRecord->dimServiceServiceID =
-            dis_add_service(thisRecord->dimServiceName,
-                            thisRecord->dimServiceFormat,
-                            thisRecord->dimData,
-                            thisRecord->dataSize, NULL, 0 );
-         /* successful ?? */
-         if ( 0 == thisRecord->dimServiceServiceID )
+         if (NULL != thisRecord->config->dimServiceGroupName)
+         {
+            /* member of a service group: published by the group's service, s. init(after=1) */
+            if (NULL == joinServiceGroup(thisRecord))
+            {
+               return errorDeactivateRecord(pRecord, __LINE__, "init_record",
+                                            "could not join service group `%s'",thisRecord->config->dimServiceGroupName);
+            }
+         }
+         else
+         {
+            /* the service routine hands DIM the record's array (zero copy)
+             * or the front buffer (double buffered), s. dimServiceRoutine() */
+            thisRecord->dimServiceServiceID =
+               dis_add_service(thisRecord->config->dimServiceName,
+                               thisRecord->config->dimServiceFormat,
+                               NULL, 0, dimServiceRoutine, recordIndex );
+         }
+         /* successful ?? (group members: ID set by startServiceGroups()) */
+         if ( 0 == thisRecord->dimServiceServiceID && NULL == thisRecord->serviceGroup )
          {
             return errorDeactivateRecord(pRecord, __LINE__, "init_record",
-                                         "could not add service service `%s'",thisRecord->dimServiceName);
+                                         "could not add service service `%s'",thisRecord->config->dimServiceName);
          }
       }
 
       /* B.2. providing a command service */
       if(true == thisRecord->dimCommandExists)
       {
+         /* I/O Intr scanning: received commands request processing via scanIoRequest() */
+         scanIoInit(&thisRecord->ioScanPvt);
+
          /*register DIM command service */
-         thisRecord->dimCommandServiceID= dis_add_cmnd(thisRecord->dimCommandName,
-                                          thisRecord->dimCommandFormat, dimCallback, recordIndex);
+         thisRecord->dimCommandServiceID= dis_add_cmnd(thisRecord->config->dimCommandName,
+                                          thisRecord->config->dimCommandFormat, dimCallback, recordIndex);
          /* check for failure */
          if ( 0 == thisRecord->dimCommandServiceID )
          {
             return errorDeactivateRecord(pRecord, __LINE__, "init_record",
-                                         "could not add command service `%s'", thisRecord->dimServiceName);
+                                         "could not add command service `%s'", thisRecord->config->dimServiceName);
          }
       }
 
-      /* B.1.b and B.2.b: start serving services */
+      /* B.1.b and B.2.b: start serving services,
+       *   done once for all records in init(after=1) */
 
       /* prerequisites
        *   - create singleton: serverName */
@@ -335,323 +553,461 @@ static long init_record(struct dbCommon	*pRecord)
                                          "makeServerName() failed");
          }
       }
-      dis_start_serving( serverName );
+      numberOfServerRecords++;
+   }
+   if (1 < dimVerbosity)
+   {
+      dumpStruct(thisRecord, stdout);
+   }
+   else if (1 == dimVerbosity)
+   {
+      dumpRecordSummary(thisRecord, stdout);
    }
-   dumpStruct(thisRecord, stdout);
 
    recordIndex++;
    return(0);
 }
 
-long copyDimToEpicsData(struct recordVariables *thisRecord)
+static long get_ioint_info(int cmd, struct dbCommon *pRecord, IOSCANPVT *ppvt)
 {
-   long status=-10;
-   /* TODO: string to number conversion sscanf,atoi,atol,atof*/
-   /* TODO: support structs */
+   /*
+    * SCAN = "I/O Intr":
+    * records receiving data from DIM (client service, server command)
+    * are processed via scanIoRequest() issued in dimCallback()
+    */
+   recordVariables *thisRecord = (recordVariables*) pRecord->dpvt;
 
-   /* Since consistency of formats has been checked by checkConsistencyFormatTypes()
-   * any available datatype discription can be chosen, 
-   * TODO: regarding string transport mode */
-   if ( false == thisRecord->dimServiceExists && false == thisRecord->dimCommandExists)
+   *ppvt = NULL;
+   if (NULL == thisRecord || NULL == thisRecord->ioScanPvt)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","copyDimToEpicsData",
-              "no format defined, cannot copy values", ((dbCommon*)(thisRecord->recordAddress))->rdes->name);
+      message(stderr,__FILE__,__LINE__,"ERROR","get_ioint_info",
+              "record `%s' receives no data from DIM, I/O Intr not supported\n", pRecord->name);
       return -1;
    }
+   *ppvt = thisRecord->ioScanPvt;
+   return 0;
+}
 
-   char dimDataType = 0;
-   char* dimDataTypeArray = NULL;
+/*
+ * conversion kernels DIM <-> EPICS (val/rval) for each DIM data type,
+ * resolved once per record by resolveConversionKernels()
+ */
+#define DIMCONVERSIONKERNELS(type, name) \
+static void dimToEpics_##name(const void *dimData, double *val, epicsInt32 *rval) \
+{ \
+   *val  = *((const type *)dimData); \
+   *rval = *val; \
+} \
+static void epicsToDim_##name(void *dimData, const double *val, epicsInt32 *rval) \
+{ \
+   *((type *)dimData) = *val; \
+   *rval = *val; \
+}
 
-   if (true == thisRecord->dimServiceExists)
+DIMCONVERSIONKERNELS(char,     C)
+DIMCONVERSIONKERNELS(int,      I)
+DIMCONVERSIONKERNELS(epicsInt32, L) /* DIM's L is 4 bytes, as I, whatever the size of C's long */
+DIMCONVERSIONKERNELS(short,    S)
+DIMCONVERSIONKERNELS(double,   D)
+DIMCONVERSIONKERNELS(float,    F)
+DIMCONVERSIONKERNELS(longlong, X) /* TODO is this a valid assignment ?*/
+
+static const struct
+{
+   char dimDataType;
+   dimToEpicsKernel dimToEpics;
+   epicsToDimKernel epicsToDim;
+} conversionKernels[] =
+   {
+      { 'C', dimToEpics_C, epicsToDim_C }
+      ,{ 'I', dimToEpics_I, epicsToDim_I }
+      ,{ 'L', dimToEpics_L, epicsToDim_L }
+      ,{ 'S', dimToEpics_S, epicsToDim_S }
+      ,{ 'D', dimToEpics_D, epicsToDim_D }
+      ,{ 'F', dimToEpics_F, epicsToDim_F }
+      ,{ 'X', dimToEpics_X, epicsToDim_X }
+   };
+
+/*
+ * array conversion kernels DIM <-> waveform FTVL,
+ * plain loops over restrict pointers, so the compiler can vectorize them
+ */
+#define DIMARRAYKERNEL(dimType, epicsType) \
+static void dimToEpicsArray_##dimType##_##epicsType(void * restrict dst, const void * restrict src, unsigned long n) \
+{ \
+   epicsType * restrict d = (epicsType *) dst; \
+   const dimType * restrict s = (const dimType *) src; \
+   unsigned long i; \
+   for (i = 0; i < n; i++) \
+   { \
+      d[i] = s[i]; \
+   } \
+} \
+static void epicsToDimArray_##dimType##_##epicsType(void * restrict dst, const void * restrict src, unsigned long n) \
+{ \
+   dimType * restrict d = (dimType *) dst; \
+   const epicsType * restrict s = (const epicsType *) src; \
+   unsigned long i; \
+   for (i = 0; i < n; i++) \
+   { \
+      d[i] = s[i]; \
+   } \
+}
+
+/* one kernel pair per FTVL (menuFtypeCHAR ... menuFtypeDOUBLE) */
+#define DIMARRAYKERNELS(dimType) \
+   DIMARRAYKERNEL(dimType, epicsInt8) \
+   DIMARRAYKERNEL(dimType, epicsUInt8) \
+   DIMARRAYKERNEL(dimType, epicsInt16) \
+   DIMARRAYKERNEL(dimType, epicsUInt16) \
+   DIMARRAYKERNEL(dimType, epicsInt32) \
+   DIMARRAYKERNEL(dimType, epicsUInt32) \
+   DIMARRAYKERNEL(dimType, epicsFloat32) \
+   DIMARRAYKERNEL(dimType, epicsFloat64)
+
+#define DIMARRAYKERNELROW(dimType, dimTypeName) \
+   { dimTypeName, sizeof(dimType), \
+     { dimToEpicsArray_##dimType##_epicsInt8,   dimToEpicsArray_##dimType##_epicsUInt8, \
+       dimToEpicsArray_##dimType##_epicsInt16,  dimToEpicsArray_##dimType##_epicsUInt16, \
+       dimToEpicsArray_##dimType##_epicsInt32,  dimToEpicsArray_##dimType##_epicsUInt32, \
+       dimToEpicsArray_##dimType##_epicsFloat32, dimToEpicsArray_##dimType##_epicsFloat64 }, \
+     { epicsToDimArray_##dimType##_epicsInt8,   epicsToDimArray_##dimType##_epicsUInt8, \
+       epicsToDimArray_##dimType##_epicsInt16,  epicsToDimArray_##dimType##_epicsUInt16, \
+       epicsToDimArray_##dimType##_epicsInt32,  epicsToDimArray_##dimType##_epicsUInt32, \
+       epicsToDimArray_##dimType##_epicsFloat32, epicsToDimArray_##dimType##_epicsFloat64 } }
+
+DIMARRAYKERNELS(char)
+DIMARRAYKERNELS(int)
+DIMARRAYKERNELS(epicsInt32)
+DIMARRAYKERNELS(short)
+DIMARRAYKERNELS(double)
+DIMARRAYKERNELS(float)
+DIMARRAYKERNELS(longlong)
+
+#define DIMNUMBEROFARRAYFTVLS (menuFtypeDOUBLE - menuFtypeCHAR + 1)
+
+static const struct
+{
+   char dimDataType;
+   size_t dimElementSize;
+   arrayKernel dimToEpics[DIMNUMBEROFARRAYFTVLS];
+   arrayKernel epicsToDim[DIMNUMBEROFARRAYFTVLS];
+} arrayConversionKernels[] =
+   {
+      DIMARRAYKERNELROW(char,     'C')
+      ,DIMARRAYKERNELROW(int,      'I')
+      ,DIMARRAYKERNELROW(epicsInt32, 'L')
+      ,DIMARRAYKERNELROW(short,    'S')
+      ,DIMARRAYKERNELROW(double,   'D')
+      ,DIMARRAYKERNELROW(float,    'F')
+      ,DIMARRAYKERNELROW(longlong, 'X')
+   };
+
+/* bit identical element types (FTVL and DIM type) are copied as a block */
+#define DIMARRAYCOPYKERNEL(size) \
+static void copyArray_##size(void * restrict dst, const void * restrict src, unsigned long n) \
+{ \
+   memcpy(dst, src, n * size); \
+}
+DIMARRAYCOPYKERNEL(1)
+DIMARRAYCOPYKERNEL(2)
+DIMARRAYCOPYKERNEL(4)
+DIMARRAYCOPYKERNEL(8)
+
+static const struct
+{
+   char dimDataType;
+   arrayKernel copy;
+} arrayCopyKernels[DIMNUMBEROFARRAYFTVLS] =
+   {
+      { 'C', copyArray_1 } /* CHAR   */
+      ,{ 'C', copyArray_1 } /* UCHAR  */
+      ,{ 'S', copyArray_2 } /* SHORT  */
+      ,{ 'S', copyArray_2 } /* USHORT */
+      ,{ 'I', copyArray_4 } /* LONG   */
+      ,{ 'I', copyArray_4 } /* ULONG  */
+      ,{ 'F', copyArray_4 } /* FLOAT  */
+      ,{ 'D', copyArray_8 } /* DOUBLE */
+   };
+
+char ftvlDefaultDIMDataType(epicsEnum16 ftvl)
+{
+   /* DIM data type matching the waveform's FTVL, 0 if there is none */
+   if (menuFtypeCHAR > ftvl || menuFtypeDOUBLE < ftvl)
    {
-      dimDataTypeArray = thisRecord->dimServiceDataTypes;
+      return 0;
    }
-   else /*(true == thisRecord->dimCommandExists)*/
+   return arrayCopyKernels[ftvl - menuFtypeCHAR].dimDataType;
+}
+
+bool resolveArrayConversionKernels(struct recordVariables *thisRecord, char dimDataType)
+{
+   unsigned int kernel = 0;
+   waveformRecord *pWaveformRecord = (waveformRecord*) thisRecord->recordAddress;
+   unsigned int ftvl = pWaveformRecord->ftvl;
+
+   if (menuFtypeCHAR > ftvl || menuFtypeDOUBLE < ftvl)
    {
-      dimDataTypeArray = thisRecord->dimCommandDataTypes;
+      message(stderr,__FILE__,__LINE__,"ERROR","resolveArrayConversionKernels",
+              "FTVL %i of record `%s' not (yet) supported", ftvl, pWaveformRecord->name);
+      return false;
    }
+   ftvl -= menuFtypeCHAR;
 
-   switch(thisRecord->recordTypeIndex)
+   for (kernel = 0; kernel < sizeof(arrayConversionKernels)/sizeof(arrayConversionKernels[0]); kernel++)
    {
-   case DIMaiRecord:
+      if (dimDataType == arrayConversionKernels[kernel].dimDataType)
       {
-         struct aiRecord *pAiRecord = (aiRecord*) thisRecord->recordAddress;
-
-         dimDataType = dimDataTypeArray[0];
-         switch(dimDataType)
+         thisRecord->dimElementSize = arrayConversionKernels[kernel].dimElementSize;
+         if (dimDataType == arrayCopyKernels[ftvl].dimDataType)
          {
-         case 'I':
-            pAiRecord->val = *((int *)thisRecord->dimData);
-            pAiRecord->rval = pAiRecord->val;
-            break;
-         case 'D':
-            ((aiRecord*) thisRecord->recordAddress)->val = *((double *)thisRecord->dimData);
-            ((aiRecord*) thisRecord->recordAddress)->rval = ((aiRecord*) thisRecord->recordAddress)->val;
-            break;
-         case 'S':
-            pAiRecord->val = *((short *)thisRecord->dimData);
-            pAiRecord->rval = pAiRecord->val;
-            break;
-         case 'C':
-            pAiRecord->val = *((char *)thisRecord->dimData);
-            pAiRecord->rval = pAiRecord->val;
-            break;
-         case 'L': /* TODO is this a valid assignment ?*/
-            pAiRecord->val = *((long *)thisRecord->dimData);
-            pAiRecord->rval = pAiRecord->val;
-            break;
-         case 'X': /* TODO is this a valid assignment ?*/
-            pAiRecord->val = *((longlong *)thisRecord->dimData);
-            pAiRecord->rval = pAiRecord->val;
-            break;
-         default:
-            {
-               message(stderr,__FILE__,__LINE__,"ERROR","copyDimToEpicsData","DIM data type '%c` not (yet) supported",dimDataType);
-               return -1;
-            }
-            break;
+            thisRecord->copyDimToEpicsArray = arrayCopyKernels[ftvl].copy;
+            thisRecord->copyEpicsToDimArray = arrayCopyKernels[ftvl].copy;
          }
-
-         /* TODO: clarify status:
-          * this line was originally in for ai record
-          * 	status = dbGetLink(&(pAiRecord->inp),DBF_DOUBLE, &(pAiRecord->val),0,0);
-          */
-         status = 0;
-      }
-      break;
-   case DIMaoRecord:
-      {
-         struct aoRecord *pAoRecord = (aoRecord*) thisRecord->recordAddress;
-         /* TODO: string to number conversion sscanf,atoi,atol,atof*/
-         /* TODO: support structs */
-
-         dimDataType = dimDataTypeArray[0];
-         switch(dimDataType)
+         else
          {
-         case 'I':
-            pAoRecord->val = *((int *)thisRecord->dimData);
-            pAoRecord->rval = pAoRecord->val;
-            break;
-         case 'D':
-            pAoRecord->val = *((double *)thisRecord->dimData);
-            pAoRecord->rval = pAoRecord->val;
-            break;
-         case 'S':
-            pAoRecord->val = *((short *)thisRecord->dimData);
-            pAoRecord->rval = pAoRecord->val;
-            break;
-         case 'C':
-            pAoRecord->val = *((char *)thisRecord->dimData);
-            pAoRecord->rval = pAoRecord->val;
-            break;
-         case 'L': /* TODO is this a valid assignment ?*/
-            pAoRecord->val = *((long *)thisRecord->dimData);
-            pAoRecord->rval = pAoRecord->val;
-            break;
-         case 'X': /* TODO is this a valid assignment ?*/
-            pAoRecord->val = *((longlong *)thisRecord->dimData);
-            pAoRecord->rval = pAoRecord->val;
-            break;
-         default:
-            {
-               message(stderr,__FILE__,__LINE__,"ERROR","copyDimToEpicsData", "DIM data type '%c` not (yet) supported",dimDataType);
-               return -1;
-            }
-            break;
+            thisRecord->copyDimToEpicsArray = arrayConversionKernels[kernel].dimToEpics[ftvl];
+            thisRecord->copyEpicsToDimArray = arrayConversionKernels[kernel].epicsToDim[ftvl];
          }
-
-         /* TODO: clarify status:
-          * this line was originally in for ai record
-          * 	status = dbGetLink(&(pAoRecord->out),DBF_DOUBLE, &(pAoRecord->val),0,0);
-          */
-         status = 0;
-      }
-      break;
-   default:
-      {
-         message(stderr,__FILE__,__LINE__,"ERROR","copyDimToEpicsData", "record type `%s' is not (yet) supported", ((dbCommon*)(thisRecord->recordAddress))->rdes->name);
-         /* TODO: What is the right way to react on this error? */
-         return -1;
+         return true;
       }
    }
-   if (0 > status)
-   {
-      message(stderr,__FILE__,__LINE__,"WARNING","copyDimToEpicsData",
-              "status of dbGetLink %i, negative for record %s\n",
-              status,((dbCommon*)(thisRecord->recordAddress))->name);
-      return -1;
 
-   }
-   return status;
+   message(stderr,__FILE__,__LINE__,"ERROR","resolveArrayConversionKernels", "DIM data type '%c` not (yet) supported",dimDataType);
+   return false;
 }
 
-long copyEpicsToDimData(struct recordVariables *thisRecord)
+bool resolveConversionKernels(struct recordVariables *thisRecord)
 {
+   /* TODO: string to number conversion sscanf,atoi,atol,atof*/
    /* TODO: support structs */
    /* TODO: support arrays */
+   unsigned int kernel = 0;
+   char dimDataType = 0;
 
    /* Since consistency of formats has been checked by checkConsistencyFormatTypes()
-    * any available datatype discription can be chosen, 
-    * TODO: regarding string transport mode */
-   if ( false == thisRecord->dimServiceExists && false == thisRecord->dimCommandExists)
+   * any available datatype discription can be chosen, 
+   * TODO: regarding string transport mode */
+   if (true == thisRecord->dimServiceExists)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","copyEpicsToDimData",
-              "no format defined, cannot copy values", ((dbCommon*)(thisRecord->recordAddress))->rdes->name);
-      return -1;
+      dimDataType = thisRecord->config->dimServiceFormatDescriptor->elements[0].type;
    }
-
-   char dimDataType = 0;
-   char* dimDataTypeArray = NULL;
-
-   if (true == thisRecord->dimServiceExists)
+   else if (true == thisRecord->dimCommandExists)
    {
-      dimDataTypeArray = thisRecord->dimServiceDataTypes;
+      dimDataType = thisRecord->config->dimCommandFormatDescriptor->elements[0].type;
    }
-   else /*(true == thisRecord->dimCommandExists)*/
+   else
    {
-      dimDataTypeArray = thisRecord->dimCommandDataTypes;
+      message(stderr,__FILE__,__LINE__,"ERROR","resolveConversionKernels",
+              "no format defined, cannot copy values of record `%s'", ((dbCommon*)(thisRecord->recordAddress))->name);
+      return false;
    }
 
-
    /* EPICS record type specific */
    switch(thisRecord->recordTypeIndex)
    {
+   case DIMwaveformRecord:
+      return resolveArrayConversionKernels(thisRecord, dimDataType);
    case DIMaiRecord:
-      {
-         struct aiRecord *pAiRecord = (aiRecord*) thisRecord->recordAddress;
-         /* TODO: string to number conversion sscanf,atoi,atol,atof*/
-
-         /* DIM type specific */
-         dimDataType = dimDataTypeArray[0];
-         switch(dimDataType)
-         {
-         case 'I':
-            *((int *)thisRecord->dimData)      = pAiRecord->val;
-            pAiRecord->rval = pAiRecord->val;
-            break;
-         case 'D':
-            *((double *)thisRecord->dimData)   = pAiRecord->val;
-            pAiRecord->rval = pAiRecord->val;
-            break;
-         case 'S':
-            *((short *)thisRecord->dimData)    = pAiRecord->val;
-            pAiRecord->rval = pAiRecord->val;
-            break;
-         case 'C':
-            *((char *)thisRecord->dimData)     = pAiRecord->val;
-            pAiRecord->rval = pAiRecord->val;
-            break;
-         case 'L':
-            *((long *)thisRecord->dimData)     = pAiRecord->val;
-            pAiRecord->rval = pAiRecord->val;
-            break;
-         case 'X':
-            *((longlong *)thisRecord->dimData) = pAiRecord->val;
-            pAiRecord->rval = pAiRecord->val;
-            break;
-         default:
-            {
-               message(stderr,__FILE__,__LINE__,"ERROR","copyEpicsToDimData", "DIM data type '%c` not (yet) supported",dimDataType);
-               return -1;
-            }
-            break;
-         }
-      }
+      thisRecord->epicsValue    = &((aiRecord*) thisRecord->recordAddress)->val;
+      thisRecord->epicsRawValue = &((aiRecord*) thisRecord->recordAddress)->rval;
       break;
    case DIMaoRecord:
-      {
-         struct aoRecord *pAoRecord = (aoRecord*) thisRecord->recordAddress;
-
-         /* TODO: string to number conversion sscanf,atoi,atol,atof*/
-
-         /* DIM type specific */
-         dimDataType = dimDataTypeArray[0];
-         switch(dimDataType)
-         {
-         case 'I':
-            *((int *)thisRecord->dimData)      = pAoRecord->val;
-            pAoRecord->rval = pAoRecord->val;
-            break;
-         case 'D':
-            *((double *)thisRecord->dimData)   = pAoRecord->val;
-            pAoRecord->rval = pAoRecord->val;
-            break;
-         case 'S':
-            *((short *)thisRecord->dimData)    = pAoRecord->val;
-            pAoRecord->rval = pAoRecord->val;
-            break;
-         case 'C':
-            *((char *)thisRecord->dimData)      = pAoRecord->val;
-            pAoRecord->rval = pAoRecord->val;
-            break;
-         case 'L':
-            *((long *)thisRecord->dimData)     = pAoRecord->val;
-            pAoRecord->rval = pAoRecord->val;
-            break;
-         case 'X':
-            *((longlong *)thisRecord->dimData) = pAoRecord->val;
-            pAoRecord->rval = pAoRecord->val;
-            break;
-         default:
-            {
-               message(stderr,__FILE__,__LINE__,"ERROR","copyEpicsToDimData", "DIM data type '%c` not (yet) supported",dimDataType);
-               return -1;
-            }
-            break;
-         }
-      }
+      thisRecord->epicsValue    = &((aoRecord*) thisRecord->recordAddress)->val;
+      thisRecord->epicsRawValue = &((aoRecord*) thisRecord->recordAddress)->rval;
       break;
    default:
       {
-         message(stderr,__FILE__,__LINE__,"ERROR","copyEpicsToDimData", "record type `%s' is not (yet) supported", ((dbCommon*)(thisRecord->recordAddress))->rdes->name);
-         return -1;
-         break;
+         message(stderr,__FILE__,__LINE__,"ERROR","resolveConversionKernels", "record type `%s' is not (yet) supported", ((dbCommon*)(thisRecord->recordAddress))->rdes->name);
+         return false;
       }
    }
-   return 0;
+
+   /* DIM type specific */
+   for (kernel = 0; kernel < sizeof(conversionKernels)/sizeof(conversionKernels[0]); kernel++)
+   {
+      if (dimDataType == conversionKernels[kernel].dimDataType)
+      {
+         thisRecord->copyDimToEpics = conversionKernels[kernel].dimToEpics;
+         thisRecord->copyEpicsToDim = conversionKernels[kernel].epicsToDim;
+         return true;
+      }
+   }
+
+   message(stderr,__FILE__,__LINE__,"ERROR","resolveConversionKernels", "DIM data type '%c` not (yet) supported",dimDataType);
+   return false;
 }
 
-static long process(struct dbCommon* pRecord)
+long copyDimToEpicsData(struct recordVariables *thisRecord)
 {
-   bool doNotConvert=true; /*workaround for the conversion from rval to val und vice versa*/
+   /* arrays: number of elements received, at most NELM */
+   if (DIMwaveformRecord == thisRecord->recordTypeIndex)
+   {
+      waveformRecord *pWaveformRecord = (waveformRecord*) thisRecord->recordAddress;
+      unsigned long elements = thisRecord->dimDataReceivedSize / thisRecord->dimElementSize;
 
-   long status=-1;
-   int ii=0;
+      /* array kernel resolved in init_record() */
+      if (NULL == thisRecord->copyDimToEpicsArray)
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","copyDimToEpicsData",
+                 "no array conversion kernel for record `%s'", pWaveformRecord->name);
+         return -1;
+      }
 
-   /* data flow:
-   * cmnd from client:							DIM = value
-   * svc on client (callback or scan active):	value = DIM
-   * cmnd on server (callback):				    value = DIM
-   * svc from server:							DIM = value
-   */
+      if (elements > pWaveformRecord->nelm)
+      {
+         elements = pWaveformRecord->nelm;
+      }
+      thisRecord->copyDimToEpicsArray(pWaveformRecord->bptr, thisRecord->dimData, elements);
+      pWaveformRecord->nord = elements;
+      return 0;
+   }
 
-   /*find index of record currently processed*/
-   for(ii=0;ii<MAX_DIMRecords;ii++)
+   /* kernel resolved in init_record() */
+   if (NULL == thisRecord->copyDimToEpics)
    {
-      if( (*recordVariablesArray[ii]).recordAddress == (int*) pRecord)
-         break;
+      message(stderr,__FILE__,__LINE__,"ERROR","copyDimToEpicsData",
+              "no conversion kernel for record `%s'", ((dbCommon*)(thisRecord->recordAddress))->name);
+      return -1;
    }
+   thisRecord->copyDimToEpics(thisRecord->dimData, thisRecord->epicsValue, thisRecord->epicsRawValue);
 
-   recordVariables *processedRecord = recordVariablesArray[ii];
+   /* TODO: clarify status:
+    * this line was originally in for ai record
+    * 	status = dbGetLink(&(pAiRecord->inp),DBF_DOUBLE, &(pAiRecord->val),0,0);
+    */
+   return 0;
+}
 
-   if( 1 == processedRecord->calledFromCallback )
+long copyEpicsToDimData(struct recordVariables *thisRecord)
+{
+   /* arrays: NORD elements, at most the size of the DIM buffer,
+    * the remainder of a service's fixed size buffer is cleared */
+   if (DIMwaveformRecord == thisRecord->recordTypeIndex)
    {
-      status = copyDimToEpicsData(processedRecord);
-      if (0 > status)
+      waveformRecord *pWaveformRecord = (waveformRecord*) thisRecord->recordAddress;
+      unsigned long elements = pWaveformRecord->nord;
+
+      /* array kernel resolved in init_record() */
+      if (NULL == thisRecord->copyEpicsToDimArray)
       {
-         message(stderr,__FILE__,__LINE__,"WARNING","process","copyDimToEpicsData failed\n");
-         return 0;
+         message(stderr,__FILE__,__LINE__,"ERROR","copyEpicsToDimData",
+                 "no array conversion kernel for record `%s'", pWaveformRecord->name);
+         return -1;
       }
 
-      /* reset toggle */
-      processedRecord->calledFromCallback = 0;
-
-      /* TODO: What is this??? */
-      if( ((DIMCLIENT == processedRecord->dimTierType ) && status != 0) || (processedRecord->dimTierType == DIMSERVER) )
+      if (elements > thisRecord->dataSize / thisRecord->dimElementSize)
       {
-         pRecord->udf = FALSE;
+         elements = thisRecord->dataSize / thisRecord->dimElementSize;
       }
-      /* TODO: PSEUDOcodeif (record type ai && datatype not int than do not convert
+
+      /* zero copy: DIM sends BPTR itself, see dimServiceRoutine() */
+      if (true == thisRecord->zeroCopy)
+      {
+         thisRecord->dimDataSendSize = elements * thisRecord->dimElementSize;
+         return 0;
+      }
+      thisRecord->copyEpicsToDimArray(thisRecord->dimData, pWaveformRecord->bptr, elements);
+      thisRecord->dimDataSendSize = elements * thisRecord->dimElementSize;
+      if (thisRecord->dimDataSendSize < thisRecord->dataSize)
+      {
+         memset((char*) thisRecord->dimData + thisRecord->dimDataSendSize, 0, thisRecord->dataSize - thisRecord->dimDataSendSize);
+      }
+      return 0;
+   }
+
+   /* kernel resolved in init_record() */
+   if (NULL == thisRecord->copyEpicsToDim)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","copyEpicsToDimData",
+              "no conversion kernel for record `%s'", ((dbCommon*)(thisRecord->recordAddress))->name);
+      return -1;
+   }
+   thisRecord->copyEpicsToDim(thisRecord->dimData, thisRecord->epicsValue, thisRecord->epicsRawValue);
+   thisRecord->dimDataSendSize = thisRecord->dataSize;
+   return 0;
+}
+
+static long process(struct dbCommon* pRecord)
+{
+   bool doNotConvert=true; /*workaround for the conversion from rval to val und vice versa*/
+
+   long status=-1;
+
+   /* data flow:
+   * cmnd from client:							DIM = value
+   * svc on client (callback or scan active):	value = DIM
+   * cmnd on server (callback):				    value = DIM
+   * svc from server:							DIM = value
+   */
+
+   /* control structure of record currently processed, bound in init_record() */
+   recordVariables *processedRecord = (recordVariables*) pRecord->dpvt;
+
+   /* check for failure */
+   if (NULL == processedRecord)
+   {
+      return errorDeactivateRecord(pRecord, __LINE__, "process","no control structure bound to record (dpvt == NULL)\n");
+   }
+
+   /* asynchronous command: second pass, completion reported by dimCommandCallback() */
+   if ( TRUE == pRecord->pact && 1 == __sync_lock_test_and_set(&processedRecord->commandPending, 0) )
+   {
+      if (1 != processedRecord->commandReturnCode)
+      {
+         __sync_fetch_and_add(&processedRecord->counters->commandsFailed, 1);
+         recGblSetSevr(pRecord, WRITE_ALARM, INVALID_ALARM);
+         message(stderr,__FILE__,__LINE__,"ERROR","process", "command `%s' of record `%s' failed! ret_code: %i\n",
+                 processedRecord->config->dimCommandName, pRecord->name, processedRecord->commandReturnCode);
+      }
+      pRecord->pact = FALSE;
+      /* updates received while active were not processed (dbProcess() skips active records) */
+      if (1 == processedRecord->calledFromCallback && (true == processedRecord->coalesceUpdates || SCAN_IO_EVENT == pRecord->scan))
+      {
+         requestProcessing(processedRecord);
+      }
+      return 2;
+   }
+
+   /* client service not available: the value is stale */
+   if ( DIMCLIENT == processedRecord->dimTierType && false == processedRecord->clientServiceCallbackOk )
+   {
+      recGblSetSevr(pRecord, COMM_ALARM, INVALID_ALARM);
+      if ( 1 == __sync_lock_test_and_set(&processedRecord->calledFromCallback, 0) )
+      {
+         /* processing requested by the loss of the link itself, nothing to convert */
+         return 2;
+      }
+   }
+
+   /* test and reset toggle, set by dimCallback() after filling the mailbox */
+   if( 1 == __sync_lock_test_and_set(&processedRecord->calledFromCallback, 0) )
+   {
+      /* consistent snapshot of the latest data received */
+      processedRecord->dimDataReceivedSize = readMailbox(&processedRecord->dimMailbox, processedRecord->dimData, processedRecord->dataSize, NULL);
+
+      status = copyDimToEpicsData(processedRecord);
+      if (0 > status)
+      {
+         message(stderr,__FILE__,__LINE__,"WARNING","process","copyDimToEpicsData failed\n");
+         return 0;
+      }
+      processedRecord->counters->processed++;
+      recordLatency(processedRecord);
+
+      /* server: republish the value received by the command */
+      if ( DIMSERVER == processedRecord->dimTierType && true == processedRecord->dimServiceExists )
+      {
+         processedRecord->dimDataSendSize = processedRecord->dimDataReceivedSize;
+         publishService(processedRecord);
+      }
+
+      /* TODO: What is this??? */
+      if( ((DIMCLIENT == processedRecord->dimTierType ) && status != 0) || (processedRecord->dimTierType == DIMSERVER) )
+      {
+         pRecord->udf = FALSE;
+      }
+      /* TODO: PSEUDOcodeif (record type ai && datatype not int than do not convert
        * i.e. return 2*/
       /*doNotConvert=true;*/
 
@@ -675,21 +1031,51 @@ static long process(struct dbCommon* pRecord)
       if( DIMCLIENT == processedRecord->dimTierType  &&  true == processedRecord->dimCommandExists )
       {
          /*TODO adopt and clean up*/
+         int ack;
+
+         /* asynchronous: do not block the scan thread, finish in a second pass */
+         if (true == processedRecord->asyncCommand)
+         {
+            __sync_lock_test_and_set(&processedRecord->commandPending, 1);
+            pRecord->pact = TRUE;
+            ack = dic_cmnd_callback( processedRecord->config->dimCommandName,
+                                     processedRecord->dimData,
+                                     processedRecord->dimDataSendSize,
+                                     dimCommandCallback,
+                                     processedRecord->index);
+            if (ack == 1)
+            {
+               processedRecord->counters->commandsSent++;
+               return 2;
+            }
+            /* not queued, no completion callback to be expected */
+            __sync_lock_release(&processedRecord->commandPending);
+            pRecord->pact = FALSE;
+            __sync_fetch_and_add(&processedRecord->counters->commandsFailed, 1);
+            recGblSetSevr(pRecord, WRITE_ALARM, INVALID_ALARM);
+            message(stderr,__FILE__,__LINE__,"ERROR","process", "dic_cmnd_callback failed! ack for dic_cmnd_callback: %i\n", ack);
+            return 2;
+         }
 
-         int ack = dic_cmnd_service( processedRecord->dimCommandName,
+         ack = dic_cmnd_service( processedRecord->config->dimCommandName,
                                      processedRecord->dimData,
-                                     processedRecord->dataSize);
+                                     processedRecord->dimDataSendSize);
          if (ack != 1)
          {
+            __sync_fetch_and_add(&processedRecord->counters->commandsFailed, 1);
             message(stderr,__FILE__,__LINE__,"ERROR","process", "dic_cmnd_service for failed! ack for dic_cmnd_service: %i\n", ack);
          }
+         else
+         {
+            processedRecord->counters->commandsSent++;
+         }
 
       }
       else  /*! (DIMCLIENT && dimCommandExists) */
       {
          if( DIMSERVER == processedRecord->dimTierType )
          {
-            dis_update_service(processedRecord->dimServiceServiceID);
+            publishService(processedRecord);
             /* TODO: Why is this set here to be FALSE */
             ((struct dbCommon*) pRecord)->udf = FALSE;
          }
@@ -742,6 +1128,31 @@ static long process(struct dbCommon* pRecord)
    }
 }
 
+void dimCommandCallback( long *tag, int *ret_code)
+{
+   /* completion of an asynchronous command issued in process(),
+    * ret_code is 1 if the command was delivered to the server */
+   recordVariables *calledBackRecord = NULL;
+
+   if (NULL == tag || 0 > *tag || recordIndex <= *tag || NULL == recordVariablesArray)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","dimCommandCallback", "invalid tag %li\n", tag ? *tag : -1L);
+      return;
+   }
+   calledBackRecord = recordVariablesArray[(int)*tag];
+   if (NULL == calledBackRecord)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","dimCommandCallback", "no record for tag %li\n", *tag);
+      return;
+   }
+   calledBackRecord->commandReturnCode = *ret_code;
+
+   /* second pass of the record via the EPICS callback threads */
+   callbackRequestProcessCallback(&calledBackRecord->config->commandCallback,
+                                  ((struct dbCommon*)calledBackRecord->recordAddress)->prio,
+                                  calledBackRecord->recordAddress);
+}
+
 void dimCallback( long *tag, int *data, int *size)
 {
    /* TODO/NOTE:
@@ -750,681 +1161,1544 @@ void dimCallback( long *tag, int *data, int *size)
     * Nevertheless the use of **data lead to errors, when double dereferencing **data, I didn't understand.
     */
     
-   struct dbCommon *pRecord;
-   struct rset *prset;
+   /* commands received by served records,
+    * client services are dispatched by dimSubscriptionCallback() */
    recordVariables *calledBackRecord = recordVariablesArray[(int)*tag];
 
-   /*If the data passed by dim matches the content of nolink, then it is
-    * the data of the *fillAddress parameter of dic_info_service, which is
-    * only passed to callback if the service failed. By chance, the data
-    * passed by dim could really be the same as nolink.*/
-
-   /*In this implementation nolink is a string, while data is a double, therefore
-    * minimizing the chances that the real content of data matches nolink.*/
-
-   if ( DIMCLIENT == calledBackRecord->dimTierType )
-   {
-      if(! strncmp((char*)data,nolink,strlen(nolink)))
-      {
-         message(stdout,__FILE__,0,"INFO","dimCallback",
-                 "Service service `%s' not available \n", calledBackRecord->dimServiceName);
-         calledBackRecord->clientServiceCallbackOk = false;
-         return;
-      }
+   /*
+    * store data in the record's mailbox,
+    * (at most dataSize bytes, no dbScanLock needed)
+    * process() reads a consistent snapshot of it into dimData
+    */
+   calledBackRecord->callbackTime = monotonicTime();
+   calledBackRecord->counters->callbacks++;
+   calledBackRecord->counters->bytesReceived += ((unsigned int) *size < calledBackRecord->dataSize) ? (unsigned int) *size : calledBackRecord->dataSize;
+   writeMailbox(&calledBackRecord->dimMailbox, (void*) data, *size);
 
-      /* back at work*/
-      if (! calledBackRecord->clientServiceCallbackOk)
-      {
-         calledBackRecord->clientServiceCallbackOk = true;
-         message(stdout,__FILE__,0,"INFO","dimCallback",
-                 "Service service `%s' is back \n", calledBackRecord->dimServiceName);
-      }
-   }
+   notifyRecord(calledBackRecord);
+}
 
-   /* memcpy */
+void notifyRecord(struct recordVariables *calledBackRecord)
+{
    /*
-    * avoid that memory areas overlap 
-    * i.e. A: beginning of data
-    *      B: end of data (= A + size)
-    *      C: beginning of dimData
-    *      D: end of dimData ( = C + dataSize ) 
-    * 
-    *      3 cases invalid:
-    *      - A == C
-    *      - A > C  && C <= B
-    *      - C > B  && D <= A 
-    *      
+    * new data in the record's mailbox:
+    * request processing (coalesced, I/O Intr) or process right away
     */
+   struct dbCommon *pRecord = (struct dbCommon*) (calledBackRecord->recordAddress);
+   struct rset *prset;
 
-   if ((calledBackRecord->dimData > (void*) data
-         && (calledBackRecord->dimData + calledBackRecord->dataSize) <= (void*) data)
-         || ((void*)data > calledBackRecord->dimData
-             && ((void*)data + *size) <= calledBackRecord->dimData)
-         || (calledBackRecord->dimData == (void*) data))
+   /* check for failure */
+   if(NULL == pRecord)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","dimCallback()", "could't copy data, because memory overlap \n");
+      message(stderr,__FILE__,__LINE__,"ERROR","notifyRecord", "pRecord in callback == NULL\n");
       return;
    }
 
-   if (*size <= calledBackRecord->dataSize)
-   {
-      memcpy(calledBackRecord->dimData, (void*) data, *size);
-   }
-   else
+   /* coalescing: keep only the latest value, request processing once per data taken by process(),
+    * the callback flag is the pending state: set, the data not yet taken, a processing is requested */
+   if ( true == calledBackRecord->coalesceUpdates )
    {
-      memcpy(calledBackRecord->dimData, (void*) data, calledBackRecord->dataSize);
-   }
+      unsigned int now = (unsigned int) (monotonicTime() / 1000000);
 
-   pRecord = (struct dbCommon*) (calledBackRecord->recordAddress);
+      if (1 == __sync_lock_test_and_set(&calledBackRecord->calledFromCallback, 1))
+      {
+         /* merged into the pending processing, unless that was not executed
+          * (record disabled or active, SCAN changed) for DIMCOALESCETIMEOUT */
+         __sync_fetch_and_add(&calledBackRecord->counters->updatesMerged, 1);
+         if (now - calledBackRecord->processRequestTime < DIMCOALESCETIMEOUT)
+         {
+            return;
+         }
+      }
+      calledBackRecord->processRequestTime = now;
+      requestProcessing(calledBackRecord);
+      return;
+   }
 
-   /* check for failure */
-   if(NULL == pRecord)
+   /* I/O Intr: leave processing to the EPICS callback threads */
+   if ( SCAN_IO_EVENT == pRecord->scan && NULL != calledBackRecord->ioScanPvt )
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","dimCallback", "pRecord in callback == NULL\n");
+      /* set callback flag, the previous data not yet processed is dropped */
+      if (1 == __sync_lock_test_and_set(&calledBackRecord->calledFromCallback, 1))
+      {
+         __sync_fetch_and_add(&calledBackRecord->counters->updatesDropped, 1);
+      }
+      scanIoRequest(calledBackRecord->ioScanPvt);
       return;
    }
 
    prset = (struct rset *) pRecord->rset;
    dbScanLock((struct dbCommon *)pRecord);
    /* set callback flag */
-   calledBackRecord->calledFromCallback = 1;
+   __sync_lock_test_and_set(&calledBackRecord->calledFromCallback, 1);
    (*prset->process)(pRecord);
    dbScanUnlock((struct dbCommon *)pRecord);
-   
-   if ( DIMSERVER == calledBackRecord->dimTierType )
-   {
-   	  if ( true == calledBackRecord->dimServiceExists )
-   	  {
-   	  	dis_update_service(calledBackRecord->dimServiceServiceID);
-   	  }
-   }
-}
-
-void serverCmndCallback(int *tag, double *data, int *size)
-{
-   message(stdout,0,0,"INFO",0,"data pointer: %p, size: %i\n", data, *size);
-   message(stdout,0,0,"INFO",0,"(double)data: %f\n", *data);
-   message(stdout,0,0,"INFO",0,"(int)	data: %i\n", *(int*)data);
-   message(stdout,0,0,"INFO",0,"(char*)	data: %s\n", (char*)data);
-   message(stdout,0,0,"INFO",0,"(char)	data: %c\n", *(char*)data);
-
-   message(stdout,0,0,"INFO",0,"CMND received from cmndClient and executed\n");
 }
 
-void error_routine (int severity, int error_code, char *messageString)
+void requestProcessing(struct recordVariables *thisRecord)
 {
-   char *errorString;
-   errorString = (char*) malloc(1024*sizeof(char));
-   switch (severity)
-   {
-   case DIM_INFO:
-      sprintf(errorString,"DIM_INFO --- ");
-      break;
-   case DIM_WARNING:
-      sprintf(errorString,"DIM_WARNING --- ");
-      break;
-   case DIM_ERROR:
-      sprintf(errorString,"DIM_ERROR --- ");
-      break;
-   case DIM_FATAL:
-      sprintf(errorString,"DIM_FATAL --- ");
-      break;
-   default:
-      sprintf(errorString,"unknown severity: %i\n",severity);
-      severity=DIM_FATAL;
-      break;
-   } 
+   /* processing by the EPICS callback threads: I/O Intr scan or the record's process callback */
+   struct dbCommon *pRecord = (struct dbCommon*) (thisRecord->recordAddress);
 
-   char value[2000];
-   switch(error_code)
+   if ( SCAN_IO_EVENT == pRecord->scan && NULL != thisRecord->ioScanPvt )
    {
-   case DIMDNSUNDEF:
-      strcat(errorString,"DIM_DNS_NODE undefined:");
-      break;
-   case DIMDNSREFUS:
-      strcat(errorString,"DIM_DNS refuses connection:");
-      break;
-   case DIMDNSDUPLC:
-      strcat(errorString,"Service already exists in DNS:");
-      break;
-   case DIMDNSEXIT:
-      strcat(errorString,"DNS request server to EXIT:");
-      break;
-   case DIMDNSTMOUT:
-      strcat(errorString,"Server failed sending watchdog:");
-      break;
-   case DIMDNSCNERR:
-      strcat(errorString,"Connection to DNS failed:");
-      break;
-   case DIMDNSCNEST:
-      strcat(errorString,"Connection to DNS established:");
-      break;
-   case DIMSVCDUPLC:
-      strcat(errorString,"Service already exists in Server:");
-      break;
-   case DIMSVCFORMT:
-      strcat(errorString,"Bad format string for service:");
-      break;
-   case DIMSVCINVAL:
-      strcat(errorString,"Invalid Service ID:");
-      break;
-   case DIMTCPRDERR:
-      strcat(errorString,"TCP/IP read error:");
-      break;
-   case DIMTCPWRRTY:
-      strcat(errorString,"TCP/IP write error - Retrying:");
-      break;
-   case DIMTCPWRTMO:
-      strcat(errorString,"TCP/IP write error - Disconnected:");
-      break;
-   case DIMTCPLNERR:
-      strcat(errorString,"TCP/IP listen error:");
-      break;
-   case DIMTCPOPERR:
-      strcat(errorString,"TCP/IP open server error :");
-      break;
-   case DIMTCPCNERR:
-      strcat(errorString,"TCP/IP connection error:");
-      break;
-   case DIMTCPCNEST:
-      strcat(errorString,"TCP/IP connection established:");
-      break;
-   default:
-      strcat(errorString,"unknown error code: ");
-      sprintf(value,"%i",severity);
-      strncat(errorString,value,strlen(value));
-      severity=DIM_FATAL;
-      break;
-
+      scanIoRequest(thisRecord->ioScanPvt);
    }
-
-   if (1023 < strlen(messageString) + strlen(errorString))
+   else
    {
-      errorString = (char*) realloc (errorString, sizeof(char)*(strlen(messageString)+1024));
+      callbackRequestProcessCallback(&thisRecord->config->processCallback, pRecord->prio, pRecord);
    }
+}
 
-   strncat(errorString,messageString, strlen(messageString)+1);
+void dimSubscriptionCallback(long *tag, int *data, int *size)
+{
+   /*
+    * update of a shared client service:
+    * each subscribed record gets its slice (offset, size) into its mailbox
+    */
+   struct dimSubscription *subscription = subscriptions[(int)*tag];
+   unsigned long long callbackTime = 0;
+   int i = 0;
 
-   char * error_services = dic_get_error_services ();
-   if (NULL != error_services)
+   /* service not available: fill address of dic_info_service(),
+    * the records are processed to raise COMM/INVALID (s. process()) */
+   if (IS_NOLINK(data))
    {
-      char msg[]="\nerroneous services: ";
-      if (1023 + strlen(messageString) < strlen(error_services) + strlen(errorString)+strlen(msg)+1)
+      if (true == subscription->serviceOk)
       {
-         errorString = (char*) realloc (errorString,
-                                        sizeof(char)*(strlen(error_services)+strlen(errorString)+strlen(msg)+2));
+         message(stdout,__FILE__,0,"INFO","dimSubscriptionCallback",
+                 "Service service `%s' not available \n", subscription->serviceName);
       }
-      strncat(errorString, msg, strlen(msg)+1);
-      strncat(errorString, error_services, strlen(error_services)+1);
+      subscription->serviceOk = false;
+      for (i = 0; i < subscription->numberOfSubscribers; i++)
+      {
+         struct recordVariables *record = subscription->subscribers[i].record;
+         if (true == record->clientServiceCallbackOk)
+         {
+            record->counters->disconnects++;
+         }
+         record->clientServiceCallbackOk = false;
+         notifyRecord(record);
+      }
+      return;
    }
-   strncat(errorString,"\n",2);
-   message(stderr, NULL, 0, NULL, NULL, "%s" ,errorString);
+   if (false == subscription->serviceOk)
+   {
+      subscription->serviceOk = true;
+      message(stdout,__FILE__,0,"INFO","dimSubscriptionCallback",
+              "Service service `%s' is back \n", subscription->serviceName);
+   }
+   subscription->updates++;
+   callbackTime = monotonicTime();
 
-   if (DIM_FATAL == severity)
+   for (i = 0; i < subscription->numberOfSubscribers; i++)
    {
-      switch(error_code)
+      struct dimSubscriber *subscriber = &subscription->subscribers[i];
+      unsigned int length = 0;
+
+      /* format changed since the record took it (s. refreshFormatCache()): not decoded */
+      if (true == subscriber->formatChanged)
       {
-      case DIMDNSEXIT:
-         free(errorString);
-         return exit_routine(&error_code);
-         break;
-      default:
-         /* do nothing */
-         break;
+         subscriber->record->clientServiceCallbackOk = false;
+         notifyRecord(subscriber->record);
+         continue;
+      }
+      subscriber->record->clientServiceCallbackOk = true;
+      if (subscriber->offset < (unsigned int) *size)
+      {
+         length = (unsigned int) *size - subscriber->offset;
+      }
+      if (length > subscriber->size)
+      {
+         length = subscriber->size;
       }
+      subscriber->record->callbackTime = callbackTime;
+      subscriber->record->counters->callbacks++;
+      subscriber->record->counters->bytesReceived += length;
+      writeMailbox(&subscriber->record->dimMailbox, (char*) data + subscriber->offset, length);
+      notifyRecord(subscriber->record);
    }
 }
 
-void exit_routine (int *code)
+struct dimSubscription* subscribeService(struct recordVariables *thisRecord)
 {
-   /* "Destructor" */
-   if (0 != *code)
-   {
-      message(stderr,__FILE__,__LINE__,"ERROR","exit_routine",
-              "Fatal DIM error or an exit command was received. Error code: %i.\n", *code);
-   }
-   int i=0;
-   for (i=0; i < recordIndex; i++)
-   {
-      if (NULL != recordVariablesArray[i])
-      {
-         clearStructRecordVariables(recordVariablesArray[i]);
-      }
-   }
-   /* epicsExit(0);*/
-}
+   /*
+    * adds the record to the subscription of its client service
+    * (same service, scan type and interval), creating it if needed,
+    * dic_info_service() is called for all subscriptions by startSubscriptions(),
+    * i.e. records sharing a service share one connection and one update per change,
+    * the DNS node is not part of the key: all subscriptions are made through the one
+    * client DNS node (list) set up by the records (s. setDnsAddress()), whatever their @D
+    */
+   char key[MAXIMUMDIMFORMATLENGTH] = {'\0'};
+   struct dimSubscription *subscription = NULL;
+   struct dimSubscriber *subscriber = NULL;
+   GPHENTRY *hashEntry = NULL;
 
-void dumpStruct ( struct recordVariables *rec, FILE *stream )
-{
-   int i=0;
-   message(stream, NULL, 0, "DUMP", NULL,"Record ---\n");
-   if (rec->recordAddress)
+   snprintf(key, MAXIMUMDIMFORMATLENGTH, "%s%s%i%s%i",
+            thisRecord->config->dimServiceName,
+            DIM_FIFTH_TOKEN, thisRecord->config->dimServiceScanType,
+            DIM_FIFTH_TOKEN, thisRecord->config->dimServiceScanInterval);
+
+   if (NULL == subscriptionTable)
    {
-      message(stream, NULL, 0, "DUMP", NULL, "%s`%s'\n","--- Record Name: ",((struct dbCommon*)rec->recordAddress)->name);
+      gphInitPvt(&subscriptionTable, 256);
    }
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tPOINTER       : record address ................................................ (recordAddress) : %p\n"
-           ,rec->recordAddress);
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tINTEGER       : record index .......................................................... (index) : %i\n"
-           ,rec->index);
-   message(stream, NULL, 0, "DUMP", NULL,
-           rec->recordType       ? "%s`%s'\n":"%s%p\n",
-           "\tSTRING POINTER: record type ...................................................... (recordType) : "
-           ,rec->recordType);
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tINTEGER       : record type index ........................................... (recordTypeIndex) : %i\n"
-           ,rec->recordTypeIndex);
-
-   message(stream, NULL, 0, "DUMP", NULL,
-           "DATA ---\n");
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tPOINTER       : data Pointer ........................................................ (dimData) : %p\n"
-           ,rec->dimData);
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tUNSIGNED INT  : data size .......................................................... (dataSize) : %i\n"
-           ,rec->dataSize);
-
-   message(stream, NULL, 0, "DUMP", NULL,"FLAGS --\n");
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tINTEGER       : calledFromCallback .................................................... (index) : %i\n"
-           ,rec->calledFromCallback);
-
-   message(stream, NULL, 0, "DUMP", NULL,"DNS --\n");
-   message(stream, NULL, 0, "DUMP", NULL,
-           rec->dimDnsAddress    ? "%s`%s'\n":"%s%p\n",
-           "\tSTRING POINTER: DIM DNS Address ............................................... (dimDnsAddress) : "
-           ,rec->dimDnsAddress);
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tINTEGER       : DIM DNS PORT ..................................................... (dimDnsPort) : %i\n"
-           ,rec->dimDnsPort);
-
-   message(stream, NULL, 0, "DUMP", NULL,"TIER ---\n");
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tCHAR          : TIER type ....................................................... (dimTierType) : '%c'\n"
-           ,rec->dimTierType);
-   message(stream, NULL, 0, "DUMP", NULL,
-           rec->dimServicesNamePrefix       ? "%s`%s'\n":"%s%p\n",
-           "\tSTRING POINTER: SERVER NAME PREFIX .................................... (dimServicesNamePrefix) : "
-           ,rec->dimServicesNamePrefix);
-
-   message(stream, NULL, 0, "DUMP", NULL,"Command ---\n");
-   message(stream, NULL, 0, "DUMP", NULL,
-           rec->dimCommandName   ? "%s`%s'\n":"%s%p\n",
-           "\tSTRING POINTER: COMMAND NAME ................................................. (dimCommandName) : "
-           ,rec->dimCommandName);
-   message(stream, NULL, 0, "DUMP", NULL,
-           rec->dimCommandFormat ? "%s`%s'\n":"%s%p\n",
-           "\tSTRING POINTER: COMMAND FORMAT ............................................. (dimCommandFormat) : "
-           ,rec->dimCommandFormat);
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tINTEGER       : no. of Command Formats ............................ (dimNumberOfCommandFormats) : %i\n"
-           ,rec->dimNumberOfCommandFormats);
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tCHAR ARRAY    : command Data types ...................................... (dimCommandDataTypes) : ");
-   if (rec->dimCommandDataTypes)
+   hashEntry = gphFind(subscriptionTable, key, NULL);
+   if (NULL != hashEntry)
    {
-      for (i=0;i<rec->dimNumberOfCommandFormats;i++)
+      subscription = (struct dimSubscription*) hashEntry->userPvt;
+      /* each subscriber takes its own slice, differing layouts are still served */
+      if (0 <= thisRecord->config->dimServiceElement
+          && false == equalFormatDescriptors(subscription->descriptor, thisRecord->config->dimServiceStructDescriptor))
       {
-         message(stream, NULL, 0, NULL, NULL,"%s'%c'\t",i?"|":"",rec->dimCommandDataTypes[i]);
+         message(stderr,__FILE__,__LINE__,"WARNING","subscribeService", "format `%s' of record `%s' differs from other subscribers of `%s'\n",
+                 thisRecord->config->dimServiceFormat, ((dbCommon*)thisRecord->recordAddress)->name, subscription->serviceName);
       }
    }
    else
    {
-      message(stream, NULL, 0, NULL, NULL,"%p"       ,rec->dimCommandDataTypes);
-   }
-   message(stream, NULL, 0,  NULL, NULL,"\n");
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tINTEGER ARRAY : no. of command Data types .............. (dimNumberOfCommandDataTypesPerFormat) : ");
-   if (rec->dimNumberOfCommandDataTypesPerFormat)
-   {
-      for (i=0;i<rec->dimNumberOfCommandFormats;i++)
+      if(0 == numberOfSubscriptions%MAX_DIMRecords)
       {
-         if (0 == rec->dimNumberOfCommandDataTypesPerFormat[i])
+         subscriptions = (struct dimSubscription**) realloc( subscriptions,
+                         sizeof(struct dimSubscription*) * (numberOfSubscriptions + MAX_DIMRecords));
+         if (NULL == subscriptions)
          {
-
-            message(stream, NULL, 0, NULL, NULL,"%s 0 (=any)\t",i?"|":"");
-         }
-         else
-         {
-            message(stream, NULL, 0, NULL, NULL,"%s %i\t",i?"|":"",rec->dimNumberOfCommandDataTypesPerFormat[i]);
+            message(stderr,__FILE__,__LINE__,"ERROR","subscribeService", "couldn't (re)allocate memory for subscriptions\n");
+            numberOfSubscriptions = 0;
+            return NULL;
          }
       }
-   }
-   else
-   {
-      message(stream, NULL, 0, NULL, NULL,"%p"       ,rec->dimNumberOfCommandDataTypesPerFormat);
-   }
-   message(stream, NULL, 0,  NULL, NULL,"\n");
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tFLAG          : command exists ............................................. (dimCommandExists) : %i (=%s)\n"
-           ,rec->dimCommandExists,rec->dimCommandExists?"true":"false");
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tINTEGER       : Command Service ID ...................................... (dimCommandServiceID) : %i\n"
-           ,rec->dimCommandServiceID);
-
-   message(stream, NULL, 0, "DUMP", NULL,
-           "Service ---\n");
-   message(stream, NULL, 0, "DUMP", NULL,
-           rec->dimServiceName   ? "%s`%s'\n":"%s%p\n",
-           "\tSTRING POINTER: SERVICE NAME ........................................................ (svcName) : "
-           ,rec->dimServiceName);
-   message(stream, NULL, 0, "DUMP", NULL,
-           rec->dimServiceFormat ? "%s`%s'\n":"%s%p\n",
-           "\tSTRING POINTER: SERVICE FORMAT ............................................. (dimServiceFormat) : "
-           ,rec->dimServiceFormat);
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tINTEGER       : no. of Service Formats ............................ (dimNumberOfServiceFormats) : %i\n"
-           ,rec->dimNumberOfServiceFormats);
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tCHAR ARRAY    : service Data types ...................................... (dimServiceDataTypes) : ");
-   if (rec->dimServiceDataTypes)
-   {
-      for (i=0;i<rec->dimNumberOfServiceFormats;i++)
+      subscription = (struct dimSubscription*) recordAlloc(sizeof(struct dimSubscription));
+      if (NULL == subscription)
       {
-         message(stream, NULL, 0, NULL, NULL,"%s'%c'\t",i?"|":"",rec->dimServiceDataTypes[i]);
+         message(stderr,__FILE__,__LINE__,"ERROR","subscribeService", "couldn't allocate memory for subscription\n");
+         return NULL;
       }
-   }
-   else
-   {
-      message(stream, NULL, 0, NULL, NULL,"%p"       ,rec->dimServiceDataTypes);
-   }
-   message(stream, NULL, 0, NULL, NULL,"\n");
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tINTEGER ARRAY : no. of service Data types .............. (dimNumberOfServiceDataTypesPerFormat) : ");
-   if (rec->dimNumberOfServiceDataTypesPerFormat)
-   {
-      for (i=0;i<rec->dimNumberOfServiceFormats;i++)
+      subscription->key          = internString(key);
+      subscription->serviceName  = thisRecord->config->dimServiceName;
+      subscription->scanType     = thisRecord->config->dimServiceScanType;
+      subscription->scanInterval = thisRecord->config->dimServiceScanInterval;
+      subscription->descriptor   = (0 <= thisRecord->config->dimServiceElement)
+                                   ? thisRecord->config->dimServiceStructDescriptor
+                                   : thisRecord->config->dimServiceFormatDescriptor;
+      subscription->serviceOk    = true;
+      subscription->index        = numberOfSubscriptions;
+      /* gphAdd does not copy the key */
+      hashEntry = gphAdd(subscriptionTable, subscription->key, NULL);
+      if (NULL == subscription->key || NULL == hashEntry)
       {
-         if (0 == rec->dimNumberOfServiceDataTypesPerFormat[i])
-         {
-            message(stream, NULL, 0, NULL, NULL,"%s 0 (=any)\t",i?"|":"");
-         }
-         else
-         {
-            message(stream, NULL, 0, NULL, NULL,"%s %i\t",i?"|":"",rec->dimNumberOfServiceDataTypesPerFormat[i]);
-         }
-         message(stream, NULL, 0, NULL, NULL,"| %i\t",rec->dimNumberOfServiceDataTypesPerFormat[i]);
+         message(stderr,__FILE__,__LINE__,"ERROR","subscribeService", "couldn't register subscription `%s'\n", key);
+         return NULL;
       }
+      hashEntry->userPvt = subscription;
+      subscriptions[numberOfSubscriptions++] = subscription;
    }
-   else
-   {
-      message(stream, NULL, 0, NULL, NULL,"%p"       ,rec->dimNumberOfServiceDataTypesPerFormat);
-   }
-   message(stream, NULL, 0, NULL, NULL,"\n");
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tFLAG          : service exists ............................................. (dimServiceExists) : %i (=%s)\n"
-           ,rec->dimServiceExists,rec->dimServiceExists?"true":"false");
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tINTEGER       : Service Service ID ...................................... (dimServiceServiceID) : %i\n"
-           ,rec->dimServiceServiceID);
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tINTEGER       : Client Service Service Scan Type ......................... (dimServiceScanType) : %i"
-           ,rec->dimServiceScanType);
-   switch (rec->dimServiceScanType)
-   {
-   case MONITORED:
-      message(stream, NULL, 0, NULL, NULL, " ( = MONITORED )\n");
-      break;
-   case TIMED:
-      message(stream, NULL, 0, NULL, NULL, " ( = TIMED )\n");
-      break;
-   default:
-      message(stream, NULL, 0, NULL, NULL, " ( = UNKNOWN )\n");
-      break;
-   }
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tINTEGER       : Client Service Service Scan Interval ................. (dimServiceScanInterval) : %i\n"
-           ,rec->dimServiceScanInterval);
-
-   message(stream, NULL, 0, "DUMP", NULL,"Xtensions ---\n");
-   message(stream, NULL, 0, "DUMP", NULL,
-           rec->dimPutDefaultSuffix ? "%s`%s'\n":"%s%p\n",
-           "\tSTRING POINTER: DEFAULT PUT SUFFIX ...................................... (dimPutDefaultSuffix) : "
-           ,rec->dimPutDefaultSuffix);
-   message(stream, NULL, 0, "DUMP", NULL,
-           rec->dimGetDefaultSuffix ? "%s`%s'\n":"%s%p\n",
-           "\tSTRING POINTER: DEFAULT GET SUFFIX ...................................... (dimGetDefaultSuffix) : "
-           ,rec->dimGetDefaultSuffix);
-
-   message(stream, NULL, 0, "DUMP", NULL,"             --- automatic creation \n");
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tFLAG          : auto create both - Service and Command ........................ (dimCreateBoth) : %i (=%s)\n"
-           ,rec->dimCreateBoth,rec->dimCreateBoth?"true":"false");
 
-   message(stream, NULL, 0, "DUMP", NULL,"             --- string transport \n");
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tFLAG          : transport via strings for commands ................... (stringTransportCommand) : %i (=%s)\n"
-           ,rec->stringTransportCommand,rec->stringTransportCommand?"true":"false");
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tFLAG          : transport via strings for services ................... (stringTransportService) : %i (=%s)\n"
-           ,rec->stringTransportService,rec->stringTransportService?"true":"false");
-   message(stream, NULL, 0, "DUMP", NULL,
-           "\tFLAG          : transport via strings for both .......................... (stringTransportBoth) : %i (=%s)\n"
-           ,rec->stringTransportBoth,rec->stringTransportBoth?"true":"false");
-
-   if ( false == rec->stringTransportCommand )
+   subscription->subscribers = (struct dimSubscriber*) realloc(subscription->subscribers,
+                               sizeof(struct dimSubscriber) * (subscription->numberOfSubscribers + 1));
+   if (NULL == subscription->subscribers)
    {
-      message(stream, NULL, 0, "DUMP", NULL,"\t.............. ommitting string transport outputs for commands\n");
+      message(stderr,__FILE__,__LINE__,"ERROR","subscribeService", "couldn't (re)allocate memory for subscribers\n");
+      subscription->numberOfSubscribers = 0;
+      return NULL;
    }
-   else
-   {
-      message(stream, NULL, 0, "DUMP", NULL,
-              rec->dimStringTransportCommandFormat ? "%s`%s'\n":"%s%p\n",
-              "\tSTRING POINTER: STRING TRANSPORT COMMAND FORMAT ..............(dimStringTransportCommandFormat) : "
-              ,rec->dimStringTransportCommandFormat);
+   subscriber = &subscription->subscribers[subscription->numberOfSubscribers++];
+   subscriber->record = thisRecord;
+   subscriber->offset = thisRecord->config->dimServiceElementOffset;
+   subscriber->size   = thisRecord->dataSize;
+   subscriber->formatChanged = false;
 
-      message(stream, NULL, 0, "DUMP", NULL,
-              "\tINTEGER       : # String Transport Command Formats . (dimStringTransportNumberOfCommandFormats) : %i\n"
-              ,rec->dimStringTransportNumberOfCommandFormats);
-      message(stream, NULL, 0, "DUMP", NULL,
-              "\tCHAR ARRAY    : String Transport command Data types ...... (dimStringTransportCommandDataTypes) : ");
-      if (rec->dimStringTransportCommandDataTypes)
-      {
-         for (i=0;i<rec->dimStringTransportNumberOfCommandFormats;i++)
-         {
-            message(stream, NULL, 0, NULL, NULL,"%s'%c'\t",i?"|":"",rec->dimStringTransportCommandDataTypes[i]);
-         }
-      }
-      else
-      {
-         message(stream, NULL, 0, NULL, NULL,"%p"       ,rec->dimStringTransportCommandDataTypes);
-      }
-      message(stream, NULL, 0, "DUMP", NULL,"\n");
-      message(stream, NULL, 0, "DUMP", NULL,
-              "\tINTEGER ARRAY : StrTrans CMND Data types  (dimStringTransportNumberOfCommandDataTypesPerFormat) : ");
-      if (rec->dimStringTransportNumberOfCommandDataTypesPerFormat)
+   thisRecord->config->dimSubscription = subscription;
+   return subscription;
+}
+
+bool startSubscriptions(void)
+{
+   /* one dic_info_service() per client service, its records are complete,
+    * the records of a service that could not be subscribed are deactivated (as by init_record()) */
+   bool status = true;
+   int i = 0, j = 0;
+   int numberOfSubscribers = 0;
+
+   for (i = 0; i < numberOfSubscriptions; i++)
+   {
+      struct dimSubscription *subscription = subscriptions[i];
+
+      numberOfSubscribers += subscription->numberOfSubscribers;
+      subscription->serviceID = dic_info_service(subscription->serviceName,
+                                                 subscription->scanType,
+                                                 subscription->scanInterval,
+                                                 0, 0, dimSubscriptionCallback, subscription->index,
+                                                 (void*) nolink, sizeof(nolink) );
+      if ( 1 > subscription->serviceID )
       {
-         for (i=0;i<rec->dimStringTransportNumberOfCommandFormats;i++)
+         message(stderr,__FILE__,__LINE__,"ERROR","startSubscriptions", "could not connect to service server `%s' as client\n",
+                 subscription->serviceName);
+         for (j = 0; j < subscription->numberOfSubscribers; j++)
          {
-            if (0 == rec->dimStringTransportNumberOfCommandDataTypesPerFormat[i])
-            {
-               message(stream, NULL, 0, NULL, NULL,"%s 0 (=any)\t",i?"|":"");
-            }
-            else
-            {
-               message(stream, NULL, 0, NULL, NULL,"%s %i\t",i?"|":"",rec->dimStringTransportNumberOfCommandDataTypesPerFormat[i]);
-            }
+            errorDeactivateRecord((struct dbCommon*) subscription->subscribers[j].record->recordAddress, __LINE__, "startSubscriptions",
+                                  "could not subscribe service `%s'", subscription->serviceName);
          }
+         status = false;
+         continue;
       }
-      else
+      for (j = 0; j < subscription->numberOfSubscribers; j++)
       {
-         message(stream, NULL, 0, NULL, NULL,"%p"       ,rec->dimStringTransportNumberOfCommandDataTypesPerFormat);
+         subscription->subscribers[j].record->dimServiceServiceID = subscription->serviceID;
       }
-      message(stream, NULL, 0, NULL, NULL,"\n");
-   }
-   if ( false == rec->stringTransportService )
-   {
-      message(stream, NULL, 0, "DUMP", NULL,"\t.............. ommitting string transport outputs for commands\n");
    }
-   else
+   if (0 < numberOfSubscriptions)
    {
-      message(stream, NULL, 0, "DUMP", NULL,
-              "\tINTEGER       : # String Transport Service Formats . (dimStringTransportNumberOfServiceFormats) : %i\n"
-              ,rec->dimStringTransportNumberOfServiceFormats);
-      message(stream, NULL, 0, "DUMP", NULL,
-              "\tCHAR ARRAY    : String Transport command Data types ...... (dimStringTransportServiceDataTypes) : ");
-      if (rec->dimStringTransportServiceDataTypes)
-      {
-         for (i=0;i<rec->dimStringTransportNumberOfServiceFormats;i++)
-         {
-            message(stream, NULL, 0, NULL, NULL,"%s'%c'\t",i?"|":"",rec->dimStringTransportServiceDataTypes[i]);
-         }
-      }
-      else
-      {
-         message(stream, NULL, 0, NULL, NULL,"%p"       ,rec->dimStringTransportServiceDataTypes);
-      }
-      message(stream, NULL, 0, NULL, NULL,"\n");
-      message(stream, NULL, 0, "DUMP", NULL,
-              "\tINTEGER ARRAY : StrTrans CMND Data types  (dimStringTransportNumberOfServiceDataTypesPerFormat) : ");
-      if (rec->dimStringTransportNumberOfServiceDataTypesPerFormat)
-      {
-         for (i=0;i<rec->dimStringTransportNumberOfServiceFormats;i++)
-         {
-            if (0 == rec->dimStringTransportNumberOfServiceDataTypesPerFormat[i])
-            {
-               message(stream, NULL, 0, NULL, NULL,"%s 0 (=any)\t",i?"|":"");
-            }
-            else
-            {
-               message(stream, NULL, 0, NULL, NULL,"%s %i\t",i?"|":"",rec->dimStringTransportNumberOfServiceDataTypesPerFormat[i]);
-            }
-         }
-      }
-      else
-      {
-         message(stream, NULL, 0, NULL, NULL,"%p"       ,rec->dimStringTransportNumberOfServiceDataTypesPerFormat);
-      }
-      message(stream, NULL, 0, NULL, NULL,"\n");
+      message(stdout,NULL,0,"INFO","startSubscriptions", "%i client service(s) subscribed for %i record(s)\n",
+              numberOfSubscriptions, numberOfSubscribers);
    }
-
-   message(stream, NULL, 0, "DUMP", NULL,"-------------------------------------------------------------------------------------------------------------------------\n");
-   fflush(stream);
+   return status;
 }
 
-void clearStructRecordVariables( struct recordVariables *thisRecord )
+bool selectServiceElement(struct recordVariables *thisRecord)
 {
-   thisRecord->dimData = NULL;
-   thisRecord->dataSize = 0;
-   thisRecord->recordAddress = NULL;
-   thisRecord->index = 0;
-   thisRecord->dimCommandServiceID = -1;
-   thisRecord->dimServiceServiceID = -1;
-   thisRecord->dimTierType = '0';
-   thisRecord->calledFromCallback = -1;
-   if (  NULL != thisRecord->dimServiceName)
-   {
-      safeStringFree(&thisRecord->dimServiceName, strlen(thisRecord->dimServiceName));
-   }
-   if (  NULL != thisRecord->dimServiceFormat)
+   /*
+    * @Se=<index>: the record uses element <index> of the struct service,
+    * its format becomes the one of the element ("<type>:<count>"),
+    * the data received is sliced at the element's offset (s. dimSubscriptionCallback())
+    */
+   struct dimFormatDescriptor *descriptor = thisRecord->config->dimServiceFormatDescriptor;
+   struct dimFormatElement *element = NULL;
+   char format[32] = {'\0'};
+
+   if (0 > thisRecord->config->dimServiceElement)
    {
-      safeStringFree(&thisRecord->dimServiceFormat, strlen(thisRecord->dimServiceFormat));
+      return true;
    }
-   if (  NULL != thisRecord->dimCommandName)
+   if (DIMCLIENT != thisRecord->dimTierType || false == thisRecord->dimServiceExists)
    {
-      safeStringFree(&thisRecord->dimCommandName, strlen(thisRecord->dimCommandName));
+      message(stderr,__FILE__,__LINE__,"ERROR","selectServiceElement", "service element (%s%c%c) only for services of a client\n",
+              DIM_PRIMARY_TOKEN, DIMSERVICE, DIMSERVICEELEMENT);
+      return false;
    }
-   if (  NULL != thisRecord->dimCommandFormat)
+   if (NULL == descriptor || (unsigned int) thisRecord->config->dimServiceElement >= descriptor->numberOfElements)
    {
-      safeStringFree(&thisRecord->dimCommandFormat, strlen(thisRecord->dimCommandFormat));
+      message(stderr,__FILE__,__LINE__,"ERROR","selectServiceElement", "service `%s' (format `%s') has no element %i\n",
+              thisRecord->config->dimServiceName, thisRecord->config->dimServiceFormat, thisRecord->config->dimServiceElement);
+      return false;
    }
-   if (  NULL != thisRecord->dimServicesNamePrefix)
+   element = &descriptor->elements[thisRecord->config->dimServiceElement];
+   if (0 == element->count)
    {
-      safeStringFree(&thisRecord->dimServicesNamePrefix, strlen(thisRecord->dimServicesNamePrefix));
+      snprintf(format, sizeof(format), "%c", element->type);
    }
-   thisRecord->dimServiceExists = false;
-   thisRecord->dimCommandExists = false;
-   if ( NULL != thisRecord->recordType  )
+   else
    {
-      safeStringFree(&thisRecord->recordType  ,strlen(thisRecord->recordType));
+      snprintf(format, sizeof(format), "%c%s%u", element->type, DIM_FIFTH_TOKEN, element->count);
    }
-   if ( NULL != thisRecord->dimDnsAddress)
+   thisRecord->config->dimServiceStructDescriptor = descriptor;
+   thisRecord->config->dimServiceElementOffset = element->offset;
+   thisRecord->config->dimServiceFormatDescriptor = compileFormat(format);
+   return (NULL != thisRecord->config->dimServiceFormatDescriptor);
+}
+
+bool setServiceGroup(struct recordVariables *thisRecord, char argument[])
+{
+   /*
+    * @Sg=<group>[:<period>]:
+    *  - group: name of the struct service the record is published in
+    *  - period: seconds between publications, without: on every change
+    */
+   char *separator = strrchr(argument, DIM_FIFTH_TOKEN[0]);
+
+   if (NULL != thisRecord->config->dimServiceGroupName)
    {
-      safeStringFree(&thisRecord->dimDnsAddress,strlen(thisRecord->dimDnsAddress));
+      message(stderr,__FILE__,__LINE__,"ERROR","setServiceGroup", "service group already set to `%s', what to choose?\n",
+              thisRecord->config->dimServiceGroupName);
+      return false;
    }
-   thisRecord->dimDnsPort = -1;
-   thisRecord->recordTypeIndex = -1;
-
-   if ( NULL != thisRecord->dimServiceDataTypes)
+   if (NULL != separator && true == checkValidUnsignedInt(separator+1))
    {
-      safeStringFree(&thisRecord->dimServiceDataTypes, thisRecord->dimNumberOfServiceFormats);
+      thisRecord->config->dimServiceGroupPeriod = atoi(separator+1);
+      *separator = '\0';
    }
-   if ( NULL != thisRecord->dimCommandDataTypes)
+   if (0 == strlen(argument))
    {
-      safeStringFree(&thisRecord->dimCommandDataTypes, thisRecord->dimNumberOfServiceFormats);
+      message(stderr,__FILE__,__LINE__,"ERROR","setServiceGroup", "empty service group name\n");
+      return false;
    }
+   return (NULL != setRecordVariablesInternedString(&(thisRecord->config->dimServiceGroupName), argument, "dimServiceGroupName", '\"'));
+}
+
+struct dimServiceGroup* joinServiceGroup(struct recordVariables *thisRecord)
+{
+   /*
+    * adds a served record to its service group, creating the group if needed,
+    * the layout and the DIM service follow in startServiceGroups()
+    */
+   struct dimServiceGroup *group = NULL;
+   struct dimFormatDescriptor *descriptor = thisRecord->config->dimServiceFormatDescriptor;
+   char *name = thisRecord->config->dimServiceGroupName;
+   GPHENTRY *hashEntry = NULL;
 
-   thisRecord->dimNumberOfServiceFormats = 0;
-   thisRecord->dimNumberOfCommandFormats = 0;
-   if ( NULL != thisRecord->dimNumberOfServiceDataTypesPerFormat)
+   if (true == thisRecord->zeroCopy || true == thisRecord->config->stringTransportService)
    {
-      SAFE_FREE(thisRecord->dimNumberOfServiceDataTypesPerFormat);
+      message(stderr,__FILE__,__LINE__,"ERROR","joinServiceGroup", "service groups are neither for zero copy nor for string transport\n");
+      return NULL;
    }
-   if ( NULL != thisRecord->dimNumberOfCommandDataTypesPerFormat)
+   if (NULL == descriptor || 1 != descriptor->numberOfElements || true == descriptor->variableLength)
    {
-      SAFE_FREE(thisRecord->dimNumberOfCommandDataTypesPerFormat);
+      message(stderr,__FILE__,__LINE__,"ERROR","joinServiceGroup", "format `%s' is not one element of fixed length, not part of a group\n",
+              thisRecord->config->dimServiceFormat);
+      return NULL;
    }
 
-   if ( NULL != thisRecord->dimGetDefaultSuffix)
+   /* same prefix as the records' services */
+   if (NULL != thisRecord->config->dimServicesNamePrefix)
    {
-      safeStringFree(&thisRecord->dimGetDefaultSuffix, strlen(thisRecord->dimGetDefaultSuffix));
-   }
+      size_t length = 1 + strlen(thisRecord->config->dimServicesNamePrefix) + strlen(DIMSERVICESPREFIXSEPARATOR) + strlen(name);
+      char prefixedName[length];
 
-   if ( NULL != thisRecord->dimPutDefaultSuffix)
-   {
-      safeStringFree(&thisRecord->dimPutDefaultSuffix, strlen(thisRecord->dimPutDefaultSuffix));
+      snprintf(prefixedName, length, "%s%s%s", thisRecord->config->dimServicesNamePrefix, DIMSERVICESPREFIXSEPARATOR, name);
+      name = internString(prefixedName);
+      if (NULL == name)
+      {
+         return NULL;
+      }
    }
 
-   thisRecord->dimServiceScanType = -1;
-   thisRecord->dimServiceScanInterval = -1;
-   thisRecord->clientServiceCallbackOk = true;
-   thisRecord->serverCommandCallbackOk = true;
-
-   thisRecord->stringTransportCommand = false;
-   thisRecord->stringTransportService = false;
-   thisRecord->stringTransportBoth = false;
-
-   if (  NULL != thisRecord->dimStringTransportServiceFormat)
+   if (NULL == serviceGroupTable)
    {
-      safeStringFree(&thisRecord->dimStringTransportServiceFormat, strlen(thisRecord->dimStringTransportServiceFormat));
+      gphInitPvt(&serviceGroupTable, 256);
    }
-   if (  NULL != thisRecord->dimStringTransportCommandFormat)
+   hashEntry = gphFind(serviceGroupTable, name, NULL);
+   if (NULL != hashEntry)
    {
-      safeStringFree(&thisRecord->dimStringTransportCommandFormat, strlen(thisRecord->dimStringTransportCommandFormat));
+      group = (struct dimServiceGroup*) hashEntry->userPvt;
+      if (group->period != thisRecord->config->dimServiceGroupPeriod)
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","joinServiceGroup", "period %i s differs from %i s of group `%s'\n",
+                 thisRecord->config->dimServiceGroupPeriod, group->period, group->name);
+         return NULL;
+      }
    }
-   thisRecord->dimStringTransportNumberOfServiceFormats = 0;
-   thisRecord->dimStringTransportNumberOfCommandFormats = 0 ;
-   if ( NULL != thisRecord->dimStringTransportNumberOfServiceDataTypesPerFormat)
+   else
    {
-      SAFE_FREE(thisRecord->dimStringTransportNumberOfServiceDataTypesPerFormat);
+      if(0 == numberOfServiceGroups%MAX_DIMRecords)
+      {
+         serviceGroups = (struct dimServiceGroup**) realloc( serviceGroups,
+                         sizeof(struct dimServiceGroup*) * (numberOfServiceGroups + MAX_DIMRecords));
+         if (NULL == serviceGroups)
+         {
+            message(stderr,__FILE__,__LINE__,"ERROR","joinServiceGroup", "couldn't (re)allocate memory for service groups\n");
+            numberOfServiceGroups = 0;
+            return NULL;
+         }
+      }
+      group = (struct dimServiceGroup*) recordAlloc(sizeof(struct dimServiceGroup));
+      if (NULL == group)
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","joinServiceGroup", "couldn't allocate memory for service group\n");
+         return NULL;
+      }
+      group->name   = name;
+      group->period = thisRecord->config->dimServiceGroupPeriod;
+      group->index  = numberOfServiceGroups;
+      group->lock   = epicsMutexCreate();
+      group->publishLock = epicsMutexCreate();
+      /* gphAdd does not copy the key */
+      hashEntry = gphAdd(serviceGroupTable, group->name, NULL);
+      if (NULL == group->lock || NULL == group->publishLock || NULL == hashEntry)
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","joinServiceGroup", "couldn't register service group `%s'\n", name);
+         return NULL;
+      }
+      hashEntry->userPvt = group;
+      serviceGroups[numberOfServiceGroups++] = group;
+   }
+
+   group->members = (struct recordVariables**) realloc(group->members,
+                    sizeof(struct recordVariables*) * (group->numberOfMembers + 1));
+   if (NULL == group->members)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","joinServiceGroup", "couldn't (re)allocate memory for members\n");
+      group->numberOfMembers = 0;
+      return NULL;
+   }
+   group->members[group->numberOfMembers++] = thisRecord;
+   thisRecord->serviceGroup = group;
+   return group;
+}
+
+bool startServiceGroups(void)
+{
+   /*
+    * per service group:
+    *  - generated format, the members' formats in order, e.g. "D:1;I:1;F:16",
+    *    laid out as a C struct (s. compileFormat()), each member at its offset
+    *  - current values, one dis_add_service()
+    *  - periodic groups: publishing thread
+    */
+   bool status = true;
+   int i = 0, j = 0;
+
+   for (i = 0; i < numberOfServiceGroups; i++)
+   {
+      struct dimServiceGroup *group = serviceGroups[i];
+      size_t length = 16 * group->numberOfMembers + 1;
+      size_t used = 0;
+
+      group->format = (char*) recordAlloc(length);
+      if (NULL == group->format)
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","startServiceGroups", "couldn't allocate memory for format of `%s'\n", group->name);
+         status = false;
+         continue;
+      }
+      for (j = 0; j < group->numberOfMembers; j++)
+      {
+         struct dimFormatElement *element = &group->members[j]->config->dimServiceFormatDescriptor->elements[0];
+         used += snprintf(group->format + used, length - used, "%s%c%s%u",
+                          j ? DIM_FOURTH_TOKEN : "", element->type, DIM_FIFTH_TOKEN, element->count);
+      }
+      group->descriptor = compileFormat(group->format);
+      if (NULL == group->descriptor)
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","startServiceGroups", "could not compile format `%s' of `%s'\n", group->format, group->name);
+         status = false;
+         continue;
+      }
+      group->size = group->descriptor->size;
+      group->buffer = calloc(1, group->size);
+      group->published[0] = calloc(1, group->size);
+      group->published[1] = calloc(1, group->size);
+      if (NULL == group->buffer || NULL == group->published[0] || NULL == group->published[1])
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","startServiceGroups", "couldn't allocate memory for buffers of `%s'\n", group->name);
+         status = false;
+         continue;
+      }
+
+      /* initial values, s. init_record() */
+      for (j = 0; j < group->numberOfMembers; j++)
+      {
+         struct recordVariables *member = group->members[j];
+         struct dimFormatElement *element = &group->descriptor->elements[j];
+         unsigned int size = element->size * element->count;
+
+         member->serviceGroupOffset = element->offset;
+         memcpy((char*) group->buffer + element->offset, member->dimServiceBuffer[member->dimServiceFront],
+                (member->dimDataSendSize < size) ? member->dimDataSendSize : size);
+      }
+      memcpy(group->published[group->publishedFront], group->buffer, group->size);
+
+      group->serviceID = dis_add_service(group->name, group->format, NULL, 0, dimServiceGroupRoutine, group->index);
+      if (0 == group->serviceID)
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","startServiceGroups", "could not add service service `%s'\n", group->name);
+         status = false;
+         continue;
+      }
+      for (j = 0; j < group->numberOfMembers; j++)
+      {
+         group->members[j]->dimServiceServiceID = group->serviceID;
+      }
+
+      if (0 < group->period)
+      {
+         if (NULL == epicsThreadCreate("dimServiceGroup", epicsThreadPriorityMedium,
+                                       epicsThreadGetStackSize(epicsThreadStackSmall),
+                                       servicePublishingThread, group))
+         {
+            message(stderr,__FILE__,__LINE__,"ERROR","startServiceGroups", "could not create publishing thread of `%s'\n", group->name);
+            status = false;
+         }
+      }
+      message(stdout,NULL,0,"INFO","startServiceGroups", "service group `%s': %i record(s), format `%s'\n",
+              group->name, group->numberOfMembers, group->format);
+   }
+   return status;
+}
+
+void publishService(struct recordVariables *thisRecord)
+{
+   /*
+    * served service updated by process():
+    * own service: swap and send,
+    * group member: copy into the group's struct, sent now or by the publishing thread
+    */
+   struct dimServiceGroup *group = thisRecord->serviceGroup;
+   unsigned int size = 0;
+
+   if (NULL == group)
+   {
+      swapServiceBuffers(thisRecord);
+      dis_update_service(thisRecord->dimServiceServiceID);
+      return;
+   }
+   if (NULL == group->buffer)
+   {
+      /* group not started (yet) */
+      return;
+   }
+
+   size = thisRecord->dataSize;
+   if (thisRecord->dimDataSendSize < size)
+   {
+      size = thisRecord->dimDataSendSize;
+   }
+   epicsMutexMustLock(group->lock);
+   memcpy((char*) group->buffer + thisRecord->serviceGroupOffset, thisRecord->dimData, size);
+   group->changed = true;
+   epicsMutexUnlock(group->lock);
+
+   if (0 == group->period)
+   {
+      publishServiceGroup(group);
+   }
+}
+
+void publishServiceGroup(struct dimServiceGroup *group)
+{
+   /*
+    * snapshot of the members' values into the back buffer, which then becomes the front buffer,
+    * and one update for all of them;
+    * DIM reads the front buffer without group->lock, so it is never written while being sent:
+    * publishers are serialised by publishLock until dis_update_service() returns,
+    * group->lock is not held while calling DIM (dimServiceGroupRoutine() takes it under DIM's own lock)
+    */
+   int back = 0;
+
+   epicsMutexMustLock(group->publishLock);
+   epicsMutexMustLock(group->lock);
+   if (false == group->changed)
+   {
+      epicsMutexUnlock(group->lock);
+      epicsMutexUnlock(group->publishLock);
+      return;
+   }
+   back = 1 - group->publishedFront;
+   memcpy(group->published[back], group->buffer, group->size);
+   group->publishedFront = back;
+   group->changed = false;
+   group->updates++;
+   epicsMutexUnlock(group->lock);
+
+   dis_update_service(group->serviceID);
+   epicsMutexUnlock(group->publishLock);
+}
+
+void servicePublishingThread(void *arg)
+{
+   /* periodic service group (@Sg=<group>:<period>): changes are sent once per period */
+   struct dimServiceGroup *group = (struct dimServiceGroup*) arg;
+
+   for (;;)
+   {
+      epicsThreadSleep((double) group->period);
+      publishServiceGroup(group);
+   }
+}
+
+void dimServiceGroupRoutine(long *tag, int **address, int *size)
+{
+   /* called by DIM whenever a service group is sent */
+   struct dimServiceGroup *group = serviceGroups[(int)*tag];
+
+   epicsMutexMustLock(group->lock);
+   *address = (int*) group->published[group->publishedFront];
+   *size = group->size;
+   epicsMutexUnlock(group->lock);
+}
+
+void swapServiceBuffers(struct recordVariables *thisRecord)
+{
+   /* double buffering of served services:
+    * the back buffer (dimData) just written becomes the front buffer sent by DIM,
+    * the former front buffer is the next one to be written */
+   int back = 1 - thisRecord->dimServiceFront;
+
+   if (NULL == thisRecord->dimServiceBuffer[back])
+   {
+      /* not double buffered (zero copy, no service) */
+      return;
+   }
+   thisRecord->dimServiceBufferSize[back] = thisRecord->dimDataSendSize;
+
+   /* buffer and size complete before they are visible to dimServiceRoutine() */
+   __sync_synchronize();
+   thisRecord->dimServiceFront = back;
+   __sync_synchronize();
+
+   thisRecord->dimData = thisRecord->dimServiceBuffer[1 - back];
+}
+
+void dimServiceRoutine(long *tag, int **address, int *size)
+{
+   /* called by DIM whenever a served service is sent:
+    * - zero copy (@Xz): the waveform's BPTR with NORD elements directly,
+    *   no intermediate copy into dimData 
+    * - otherwise: the front buffer of swapServiceBuffers() */
+   recordVariables *servedRecord = recordVariablesArray[(int)*tag];
+   int front = 0;
+
+   if (NULL == servedRecord)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","dimServiceRoutine", "no record for tag %li\n", *tag);
+      *address = NULL;
+      *size = 0;
+      return;
+   }
+
+   if (true == servedRecord->zeroCopy)
+   {
+      waveformRecord *pWaveformRecord = (waveformRecord*) servedRecord->recordAddress;
+      unsigned int maxSize = pWaveformRecord->nelm * servedRecord->dimElementSize;
+
+      *address = (int*) pWaveformRecord->bptr;
+      *size = (servedRecord->dimDataSendSize < maxSize) ? servedRecord->dimDataSendSize : maxSize;
+      return;
+   }
+
+   front = servedRecord->dimServiceFront;
+   __sync_synchronize();
+   *address = (int*) servedRecord->dimServiceBuffer[front];
+   *size = servedRecord->dimServiceBufferSize[front];
+}
+
+void serverCmndCallback(int *tag, double *data, int *size)
+{
+   message(stdout,0,0,"INFO",0,"data pointer: %p, size: %i\n", data, *size);
+   message(stdout,0,0,"INFO",0,"(double)data: %f\n", *data);
+   message(stdout,0,0,"INFO",0,"(int)	data: %i\n", *(int*)data);
+   message(stdout,0,0,"INFO",0,"(char*)	data: %s\n", (char*)data);
+   message(stdout,0,0,"INFO",0,"(char)	data: %c\n", *(char*)data);
+
+   message(stdout,0,0,"INFO",0,"CMND received from cmndClient and executed\n");
+}
+
+void error_routine (int severity, int error_code, char *messageString)
+{
+   char *errorString;
+   errorString = (char*) malloc(1024*sizeof(char));
+   switch (severity)
+   {
+   case DIM_INFO:
+      sprintf(errorString,"DIM_INFO --- ");
+      break;
+   case DIM_WARNING:
+      sprintf(errorString,"DIM_WARNING --- ");
+      break;
+   case DIM_ERROR:
+      sprintf(errorString,"DIM_ERROR --- ");
+      break;
+   case DIM_FATAL:
+      sprintf(errorString,"DIM_FATAL --- ");
+      break;
+   default:
+      sprintf(errorString,"unknown severity: %i\n",severity);
+      severity=DIM_FATAL;
+      break;
+   } 
+
+   char value[2000];
+   switch(error_code)
+   {
+   case DIMDNSUNDEF:
+      strcat(errorString,"DIM_DNS_NODE undefined:");
+      break;
+   case DIMDNSREFUS:
+      strcat(errorString,"DIM_DNS refuses connection:");
+      break;
+   case DIMDNSDUPLC:
+      strcat(errorString,"Service already exists in DNS:");
+      break;
+   case DIMDNSEXIT:
+      strcat(errorString,"DNS request server to EXIT:");
+      break;
+   case DIMDNSTMOUT:
+      strcat(errorString,"Server failed sending watchdog:");
+      break;
+   case DIMDNSCNERR:
+      strcat(errorString,"Connection to DNS failed:");
+      break;
+   case DIMDNSCNEST:
+      strcat(errorString,"Connection to DNS established:");
+      break;
+   case DIMSVCDUPLC:
+      strcat(errorString,"Service already exists in Server:");
+      break;
+   case DIMSVCFORMT:
+      strcat(errorString,"Bad format string for service:");
+      break;
+   case DIMSVCINVAL:
+      strcat(errorString,"Invalid Service ID:");
+      break;
+   case DIMTCPRDERR:
+      strcat(errorString,"TCP/IP read error:");
+      break;
+   case DIMTCPWRRTY:
+      strcat(errorString,"TCP/IP write error - Retrying:");
+      break;
+   case DIMTCPWRTMO:
+      strcat(errorString,"TCP/IP write error - Disconnected:");
+      break;
+   case DIMTCPLNERR:
+      strcat(errorString,"TCP/IP listen error:");
+      break;
+   case DIMTCPOPERR:
+      strcat(errorString,"TCP/IP open server error :");
+      break;
+   case DIMTCPCNERR:
+      strcat(errorString,"TCP/IP connection error:");
+      break;
+   case DIMTCPCNEST:
+      strcat(errorString,"TCP/IP connection established:");
+      break;
+   default:
+      strcat(errorString,"unknown error code: ");
+      sprintf(value,"%i",severity);
+      strncat(errorString,value,strlen(value));
+      severity=DIM_FATAL;
+      break;
+
+   }
+
+   if (1023 < strlen(messageString) + strlen(errorString))
+   {
+      errorString = (char*) realloc (errorString, sizeof(char)*(strlen(messageString)+1024));
+   }
+
+   strncat(errorString,messageString, strlen(messageString)+1);
+
+   char * error_services = dic_get_error_services ();
+   if (NULL != error_services)
+   {
+      char msg[]="\nerroneous services: ";
+      if (1023 + strlen(messageString) < strlen(error_services) + strlen(errorString)+strlen(msg)+1)
+      {
+         errorString = (char*) realloc (errorString,
+                                        sizeof(char)*(strlen(error_services)+strlen(errorString)+strlen(msg)+2));
+      }
+      strncat(errorString, msg, strlen(msg)+1);
+      strncat(errorString, error_services, strlen(error_services)+1);
+   }
+   strncat(errorString,"\n",2);
+   message(stderr, NULL, 0, NULL, NULL, "%s" ,errorString);
+
+   if (DIM_FATAL == severity)
+   {
+      switch(error_code)
+      {
+      case DIMDNSEXIT:
+         free(errorString);
+         return exit_routine(&error_code);
+         break;
+      default:
+         /* do nothing */
+         break;
+      }
+   }
+}
+
+void exit_routine (int *code)
+{
+   /* "Destructor" */
+   if (0 != *code)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","exit_routine",
+              "Fatal DIM error or an exit command was received. Error code: %i.\n", *code);
+   }
+   int i=0;
+   for (i=0; i < recordIndex; i++)
+   {
+      if (NULL != recordVariablesArray[i])
+      {
+         clearStructRecordVariables(recordVariablesArray[i]);
+      }
+   }
+   /* epicsExit(0);*/
+}
+
+void dumpRecordSummary ( struct recordVariables *rec, FILE *stream )
+{
+   /* one line per record: name, type, tier, service and command with their formats */
+   message(stream, NULL, 0, "DUMP", NULL, "#%i `%s' (%s) %c: service `%s' (%s), command `%s' (%s), %u bytes%s\n",
+           rec->index,
+           rec->recordAddress ? ((struct dbCommon*)rec->recordAddress)->name : "",
+           rec->config->recordType ? rec->config->recordType : "?",
+           rec->dimTierType,
+           rec->dimServiceExists ? rec->config->dimServiceName : "-",
+           rec->dimServiceExists ? rec->config->dimServiceFormat : "-",
+           rec->dimCommandExists ? rec->config->dimCommandName : "-",
+           rec->dimCommandExists ? rec->config->dimCommandFormat : "-",
+           rec->dataSize,
+           rec->config->dimDnsAddress ? "" : ", default DNS");
+}
+
+void dimDumpRecord(char *recordName)
+{
+   /* iocsh: all fields of one record (dumpStruct()) */
+   int i = 0;
+
+   if (NULL == recordName || 0 == strlen(recordName))
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","dimDumpRecord", "usage: dimDumpRecord <record name>\n");
+      return;
+   }
+   for (i = 0; i < recordIndex; i++)
+   {
+      struct recordVariables *rec = recordVariablesArray[i];
+      if (NULL != rec && NULL != rec->recordAddress
+          && 0 == strcmp(recordName, ((struct dbCommon*)rec->recordAddress)->name))
+      {
+         dumpStruct(rec, stdout);
+         return;
+      }
+   }
+   message(stderr,__FILE__,__LINE__,"ERROR","dimDumpRecord", "`%s' is not a record of %s\n", recordName, DIMDEVICETYPE);
+}
+
+unsigned long long monotonicTime(void)
+{
+   /* ns, for intervals only */
+   struct timespec now;
+
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (unsigned long long) now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+void recordLatency(struct recordVariables *thisRecord)
+{
+   /* time from the latest DIM callback to its processing, histogram bin: log2 of us */
+   unsigned long long latency = 0;
+   int bin = 0;
+
+   if (0 == thisRecord->callbackTime)
+   {
+      return;
+   }
+   latency = (monotonicTime() - thisRecord->callbackTime) / 1000;
+   while (0 < latency && bin < DIMLATENCYBINS - 1)
+   {
+      latency >>= 1;
+      bin++;
+   }
+   thisRecord->counters->latency[bin]++;
+}
+
+void addStatistics(struct dimStatistics *statistics, struct recordVariables *thisRecord)
+{
+   int i = 0;
+
+   statistics->numberOfRecords++;
+   statistics->callbacks      += thisRecord->counters->callbacks;
+   statistics->bytes          += thisRecord->counters->bytesReceived;
+   statistics->processed      += thisRecord->counters->processed;
+   statistics->commandsSent   += thisRecord->counters->commandsSent;
+   statistics->commandsFailed += thisRecord->counters->commandsFailed;
+   statistics->disconnects    += thisRecord->counters->disconnects;
+   for (i = 0; i < DIMLATENCYBINS; i++)
+   {
+      statistics->latency[i] += thisRecord->counters->latency[i];
+   }
+}
+
+void reportStatistics(struct dimStatistics *statistics, int level)
+{
+   /* one line, from level 3 on the latency histogram (non empty bins, upper limit in us) in a second one */
+   int i = 0;
+
+   message(stdout,NULL,0,NULL,NULL,"\t`%s': %i record(s), received: %lu (%lu bytes), processed: %lu, commands: %lu (failed: %lu), disconnects: %lu\n",
+           statistics->name, statistics->numberOfRecords, statistics->callbacks, statistics->bytes,
+           statistics->processed, statistics->commandsSent, statistics->commandsFailed, statistics->disconnects);
+   if (3 > level || 0 == statistics->processed)
+   {
+      return;
+   }
+   message(stdout,NULL,0,NULL,NULL,"\t\tlatency [us]:");
+   for (i = 0; i < DIMLATENCYBINS; i++)
+   {
+      if (0 != statistics->latency[i])
+      {
+         message(stdout,NULL,0,NULL,NULL," %s%lu: %lu", (DIMLATENCYBINS - 1 == i) ? ">=" : "<",
+                 (DIMLATENCYBINS - 1 == i) ? 1UL << (i - 1) : 1UL << i, statistics->latency[i]);
+      }
+   }
+   message(stdout,NULL,0,NULL,NULL,"\n");
+}
+
+void reportStatisticsBy(int level, bool byDnsNode)
+{
+   /* counters of all records summed up per DIM service (or command) or per DNS node */
+   void *table = NULL;
+   struct dimStatistics *statistics = NULL;
+   int numberOfEntries = 0;
+   int i = 0;
+
+   if (0 == recordIndex)
+   {
+      return;
+   }
+   statistics = (struct dimStatistics*) calloc(recordIndex, sizeof(struct dimStatistics));
+   if (NULL == statistics)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","reportStatisticsBy", "couldn't allocate memory\n");
+      return;
+   }
+   gphInitPvt(&table, 256);
+
+   for (i = 0; i < recordIndex; i++)
+   {
+      struct recordVariables *rec = recordVariablesArray[i];
+      GPHENTRY *hashEntry = NULL;
+      char *name = NULL;
+
+      if (NULL == rec || NULL == rec->config)
+      {
+         continue;
+      }
+      if (true == byDnsNode)
+      {
+         name = rec->config->dimDnsAddress ? rec->config->dimDnsAddress : "(DIM_DNS_NODE)";
+      }
+      else
+      {
+         name = rec->dimServiceExists ? rec->config->dimServiceName : rec->config->dimCommandName;
+      }
+      if (NULL == name)
+      {
+         continue;
+      }
+      hashEntry = gphFind(table, name, NULL);
+      if (NULL == hashEntry)
+      {
+         hashEntry = gphAdd(table, name, NULL);
+         if (NULL == hashEntry)
+         {
+            continue;
+         }
+         statistics[numberOfEntries].name = name;
+         hashEntry->userPvt = &statistics[numberOfEntries++];
+      }
+      addStatistics((struct dimStatistics*) hashEntry->userPvt, rec);
+   }
+
+   message(stdout,NULL,0,NULL,NULL,"\tper %s:\n", byDnsNode ? "DNS node" : "service");
+   for (i = 0; i < numberOfEntries; i++)
+   {
+      reportStatistics(&statistics[i], level);
+   }
+   gphFreeMem(table);
+   free(statistics);
+}
+
+static long statisticsInitRecord(struct aiRecord *pRecord)
+{
+   /* INP: @<name of the statistics value> */
+   char *name = NULL;
+   int i = 0;
+
+   if (INST_IO != pRecord->inp.type)
+   {
+      return errorDeactivateRecord((struct dbCommon*) pRecord, __LINE__, "statisticsInitRecord",
+                                   "INP is not INST_IO (@<name>)");
+   }
+   name = pRecord->inp.value.instio.string;
+   while (NULL != name && isspace(*name))
+   {
+      name++;
+   }
+   for (i = 0; NULL != name && i < DIMStatisticsLastDummyEntry; i++)
+   {
+      if (0 == strcmp(name, DIMInterfaceStatisticsNames[i]))
+      {
+         break;
+      }
+   }
+   if (NULL == name || DIMStatisticsLastDummyEntry == i)
+   {
+      return errorDeactivateRecord((struct dbCommon*) pRecord, __LINE__, "statisticsInitRecord",
+                                   "`%s' is not a statistics value of %s", name ? name : "", DIMSTATISTICSDEVICETYPE);
+   }
+   /* records are initialised one after the other */
+   if (NULL == statisticsLock)
+   {
+      statisticsLock = epicsMutexCreate();
+      if (NULL == statisticsLock)
+      {
+         return errorDeactivateRecord((struct dbCommon*) pRecord, __LINE__, "statisticsInitRecord",
+                                      "couldn't create mutex");
+      }
+   }
+   pRecord->dpvt = &DIMInterfaceStatisticsNames[i];
+   return 0;
+}
+
+static long statisticsRead(struct aiRecord *pRecord)
+{
+   int i = (char**) pRecord->dpvt - DIMInterfaceStatisticsNames;
+
+   updateStatistics();
+   epicsMutexMustLock(statisticsLock);
+   pRecord->val = statisticsValues[i];
+   epicsMutexUnlock(statisticsLock);
+   pRecord->udf = FALSE;
+   return 2;
+}
+
+double latencyPercentile(unsigned long histogram[], double fraction)
+{
+   /* upper limit (us) of the histogram bin holding the fraction of all entries, 0: empty */
+   unsigned long numberOfEntries = 0;
+   unsigned long sum = 0;
+   int i = 0;
+
+   for (i = 0; i < DIMLATENCYBINS; i++)
+   {
+      numberOfEntries += histogram[i];
+   }
+   if (0 == numberOfEntries)
+   {
+      return 0.;
+   }
+   for (i = 0; i < DIMLATENCYBINS - 1; i++)
+   {
+      sum += histogram[i];
+      if ((double) sum >= fraction * numberOfEntries)
+      {
+         break;
+      }
+   }
+   return (DIMLATENCYBINS - 1 == i) ? (double) (1UL << (i - 1)) : (double) (1UL << i);
+}
+
+void updateStatistics(void)
+{
+   /*
+    * sums up the records' counters (s. addStatistics()),
+    * rates and latency percentiles since the previous update,
+    * at most once per DIMSTATISTICSMINIMUMPERIOD
+    */
+   struct dimStatistics total;
+   unsigned long latency[DIMLATENCYBINS];
+   unsigned long long now = monotonicTime();
+   double interval = 0.;
+   int pending = 0;
+   int disconnected = 0;
+   int i = 0;
+
+   epicsMutexMustLock(statisticsLock);
+   if (0 != statisticsTime && now - statisticsTime < DIMSTATISTICSMINIMUMPERIOD)
+   {
+      epicsMutexUnlock(statisticsLock);
+      return;
+   }
+
+   memset(&total, 0, sizeof(total));
+   for (i = 0; i < recordIndex; i++)
+   {
+      struct recordVariables *rec = recordVariablesArray[i];
+      if (NULL == rec)
+      {
+         continue;
+      }
+      addStatistics(&total, rec);
+      pending += (0 != rec->calledFromCallback);
+   }
+   for (i = 0; i < numberOfSubscriptions; i++)
+   {
+      disconnected += (false == subscriptions[i]->serviceOk);
+   }
+
+   if (0 != statisticsTime)
+   {
+      interval = (now - statisticsTime) * 1e-9;
+      statisticsValues[DIMStatisticsCallbackRate] = (total.callbacks - statisticsPrevious.callbacks) / interval;
+      statisticsValues[DIMStatisticsProcessRate]  = (total.processed - statisticsPrevious.processed) / interval;
+      statisticsValues[DIMStatisticsByteRate]     = (total.bytes - statisticsPrevious.bytes) / interval;
+   }
+   for (i = 0; i < DIMLATENCYBINS; i++)
+   {
+      latency[i] = total.latency[i] - statisticsPrevious.latency[i];
+   }
+   statisticsValues[DIMStatisticsLatencyP50] = latencyPercentile(latency, 0.50);
+   statisticsValues[DIMStatisticsLatencyP90] = latencyPercentile(latency, 0.90);
+   statisticsValues[DIMStatisticsLatencyP99] = latencyPercentile(latency, 0.99);
+
+   statisticsValues[DIMStatisticsRecords]              = recordIndex;
+   statisticsValues[DIMStatisticsPendingProcessing]    = pending;
+   statisticsValues[DIMStatisticsMessageQueue]         = messageQueueDepth();
+   statisticsValues[DIMStatisticsDisconnectedServices] = disconnected;
+   statisticsValues[DIMStatisticsCommandsFailed]       = total.commandsFailed;
+
+   statisticsPrevious = total;
+   statisticsTime = now;
+   epicsMutexUnlock(statisticsLock);
+}
+
+void dimReport(int level)
+{
+   /* iocsh: same as dbior for this device support */
+   report(level);
+}
+
+void dumpStruct ( struct recordVariables *rec, FILE *stream )
+{
+   int i=0;
+   message(stream, NULL, 0, "DUMP", NULL,"Record ---\n");
+   if (rec->recordAddress)
+   {
+      message(stream, NULL, 0, "DUMP", NULL, "%s`%s'\n","--- Record Name: ",((struct dbCommon*)rec->recordAddress)->name);
+   }
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tPOINTER       : record address ................................................ (recordAddress) : %p\n"
+           ,rec->recordAddress);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tINTEGER       : record index .......................................................... (index) : %i\n"
+           ,rec->index);
+   message(stream, NULL, 0, "DUMP", NULL,
+           rec->config->recordType       ? "%s`%s'\n":"%s%p\n",
+           "\tSTRING POINTER: record type ...................................................... (recordType) : "
+           ,rec->config->recordType);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tINTEGER       : record type index ........................................... (recordTypeIndex) : %i\n"
+           ,rec->recordTypeIndex);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tFUNCTION      : conversion kernel DIM -> EPICS ............................ (copyDimToEpics) : %p\n"
+           ,rec->copyDimToEpics);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tFUNCTION      : conversion kernel EPICS -> DIM ............................ (copyEpicsToDim) : %p\n"
+           ,rec->copyEpicsToDim);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tFUNCTION      : array conversion kernel DIM -> EPICS .................. (copyDimToEpicsArray) : %p\n"
+           ,rec->copyDimToEpicsArray);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tFUNCTION      : array conversion kernel EPICS -> DIM .................. (copyEpicsToDimArray) : %p\n"
+           ,rec->copyEpicsToDimArray);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED INT  : size of one DIM array element ............................. (dimElementSize) : %u\n"
+           ,rec->dimElementSize);
+
+   message(stream, NULL, 0, "DUMP", NULL,
+           "DATA ---\n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tPOINTER       : data Pointer ........................................................ (dimData) : %p\n"
+           ,rec->dimData);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED INT  : data size .......................................................... (dataSize) : %i\n"
+           ,rec->dataSize);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED INT  : data size last received ......................... (dimDataReceivedSize) : %u\n"
+           ,rec->dimDataReceivedSize);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED INT  : data size last sent ................................. (dimDataSendSize) : %u\n"
+           ,rec->dimDataSendSize);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tPOINTER       : mailbox data pointer ........................................ (dimMailbox.data) : %p\n"
+           ,rec->dimMailbox.data);
+
+   message(stream, NULL, 0, "DUMP", NULL,"FLAGS --\n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tINTEGER       : calledFromCallback .................................................... (index) : %i\n"
+           ,rec->calledFromCallback);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tPOINTER       : I/O Intr scan list ................................................ (ioScanPvt) : %p\n"
+           ,rec->ioScanPvt);
+
+   message(stream, NULL, 0, "DUMP", NULL,"DNS --\n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           rec->config->dimDnsAddress    ? "%s`%s'\n":"%s%p\n",
+           "\tSTRING POINTER: DIM DNS Address ............................................... (dimDnsAddress) : "
+           ,rec->config->dimDnsAddress);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tINTEGER       : DIM DNS PORT ..................................................... (dimDnsPort) : %i\n"
+           ,rec->config->dimDnsPort);
+
+   message(stream, NULL, 0, "DUMP", NULL,"TIER ---\n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tCHAR          : TIER type ....................................................... (dimTierType) : '%c'\n"
+           ,rec->dimTierType);
+   message(stream, NULL, 0, "DUMP", NULL,
+           rec->config->dimServicesNamePrefix       ? "%s`%s'\n":"%s%p\n",
+           "\tSTRING POINTER: SERVER NAME PREFIX .................................... (dimServicesNamePrefix) : "
+           ,rec->config->dimServicesNamePrefix);
+
+   message(stream, NULL, 0, "DUMP", NULL,"Command ---\n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           rec->config->dimCommandName   ? "%s`%s'\n":"%s%p\n",
+           "\tSTRING POINTER: COMMAND NAME ................................................. (dimCommandName) : "
+           ,rec->config->dimCommandName);
+   message(stream, NULL, 0, "DUMP", NULL,
+           rec->config->dimCommandFormat ? "%s`%s'\n":"%s%p\n",
+           "\tSTRING POINTER: COMMAND FORMAT ............................................. (dimCommandFormat) : "
+           ,rec->config->dimCommandFormat);
+   dumpFormatDescriptor(stream,
+                        "\tDESCRIPTOR    : command format descriptor ............................ (dimCommandFormatDescriptor) :\n",
+                        rec->config->dimCommandFormatDescriptor);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tFLAG          : command exists ............................................. (dimCommandExists) : %i (=%s)\n"
+           ,rec->dimCommandExists,rec->dimCommandExists?"true":"false");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tINTEGER       : Command Service ID ...................................... (dimCommandServiceID) : %i\n"
+           ,rec->dimCommandServiceID);
+
+   message(stream, NULL, 0, "DUMP", NULL,
+           "Service ---\n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           rec->config->dimServiceName   ? "%s`%s'\n":"%s%p\n",
+           "\tSTRING POINTER: SERVICE NAME ........................................................ (svcName) : "
+           ,rec->config->dimServiceName);
+   message(stream, NULL, 0, "DUMP", NULL,
+           rec->config->dimServiceFormat ? "%s`%s'\n":"%s%p\n",
+           "\tSTRING POINTER: SERVICE FORMAT ............................................. (dimServiceFormat) : "
+           ,rec->config->dimServiceFormat);
+   dumpFormatDescriptor(stream,
+                        "\tDESCRIPTOR    : service format descriptor ............................ (dimServiceFormatDescriptor) :\n",
+                        rec->config->dimServiceFormatDescriptor);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tFLAG          : service exists ............................................. (dimServiceExists) : %i (=%s)\n"
+           ,rec->dimServiceExists,rec->dimServiceExists?"true":"false");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tINTEGER       : Service Service ID ...................................... (dimServiceServiceID) : %i\n"
+           ,rec->dimServiceServiceID);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tINTEGER       : Client Service Service Scan Type ......................... (dimServiceScanType) : %i"
+           ,rec->config->dimServiceScanType);
+   switch (rec->config->dimServiceScanType)
+   {
+   case MONITORED:
+      message(stream, NULL, 0, NULL, NULL, " ( = MONITORED )\n");
+      break;
+   case TIMED:
+      message(stream, NULL, 0, NULL, NULL, " ( = TIMED )\n");
+      break;
+   default:
+      message(stream, NULL, 0, NULL, NULL, " ( = UNKNOWN )\n");
+      break;
+   }
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tINTEGER       : Client Service Service Scan Interval ................. (dimServiceScanInterval) : %i\n"
+           ,rec->config->dimServiceScanInterval);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tINTEGER       : Client Service Element (offset %5u) .................... (dimServiceElement) : %i\n"
+           ,rec->config->dimServiceElementOffset, rec->config->dimServiceElement);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tPOINTER       : shared subscription .................................... (dimSubscription) : %p\n"
+           ,rec->config->dimSubscription);
+   message(stream, NULL, 0, "DUMP", NULL,
+           rec->config->dimServiceGroupName ? "%s`%s' (period %i s, offset %u)\n":"%s%p\n",
+           "\tSTRING        : Server Service Group ................................. (dimServiceGroupName) : "
+           ,rec->config->dimServiceGroupName, rec->config->dimServiceGroupPeriod, rec->serviceGroupOffset);
+
+   message(stream, NULL, 0, "DUMP", NULL,"Xtensions ---\n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           rec->config->dimPutDefaultSuffix ? "%s`%s'\n":"%s%p\n",
+           "\tSTRING POINTER: DEFAULT PUT SUFFIX ...................................... (dimPutDefaultSuffix) : "
+           ,rec->config->dimPutDefaultSuffix);
+   message(stream, NULL, 0, "DUMP", NULL,
+           rec->config->dimGetDefaultSuffix ? "%s`%s'\n":"%s%p\n",
+           "\tSTRING POINTER: DEFAULT GET SUFFIX ...................................... (dimGetDefaultSuffix) : "
+           ,rec->config->dimGetDefaultSuffix);
+
+   message(stream, NULL, 0, "DUMP", NULL,"             --- automatic creation \n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tFLAG          : auto create both - Service and Command ........................ (dimCreateBoth) : %i (=%s)\n"
+           ,rec->config->dimCreateBoth,rec->config->dimCreateBoth?"true":"false");
+
+   message(stream, NULL, 0, "DUMP", NULL,"             --- update coalescing \n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tFLAG          : keep latest update only, process once ................... (coalesceUpdates) : %i (=%s)\n"
+           ,rec->coalesceUpdates,rec->coalesceUpdates?"true":"false");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED LONG : updates merged into pending processing ................... (updatesMerged) : %lu\n"
+           ,rec->counters->updatesMerged);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED INT  : ms (monotonic) of the latest processing requested ..... (processRequestTime) : %u\n"
+           ,rec->processRequestTime);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED LONG : updates overwritten before processing ................... (updatesDropped) : %lu\n"
+           ,rec->counters->updatesDropped);
+
+   message(stream, NULL, 0, "DUMP", NULL,"             --- asynchronous command \n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tFLAG          : command via dic_cmnd_callback, completed in 2nd pass ..... (asyncCommand) : %i (=%s)\n"
+           ,rec->asyncCommand,rec->asyncCommand?"true":"false");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tINT           : last ret_code of the command callback ............ (commandReturnCode) : %i\n"
+           ,rec->commandReturnCode);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED LONG : failed commands ...................................... (commandsFailed) : %lu\n"
+           ,rec->counters->commandsFailed);
+
+   message(stream, NULL, 0, "DUMP", NULL,"             --- counters \n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED LONG : updates/commands received from DIM ........................ (callbacks) : %lu\n"
+           ,rec->counters->callbacks);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED LONG : bytes received ........................................... (bytesReceived) : %lu\n"
+           ,rec->counters->bytesReceived);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED LONG : processings with data received ............................... (processed) : %lu\n"
+           ,rec->counters->processed);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED LONG : commands sent ............................................. (commandsSent) : %lu\n"
+           ,rec->counters->commandsSent);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED LONG : client service lost ........................................ (disconnects) : %lu\n"
+           ,rec->counters->disconnects);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tUNSIGNED LONG : latency callback -> process(), log2 us ........................ (latency) :");
+   for (i = 0; i < DIMLATENCYBINS; i++)
+   {
+      message(stream, NULL, 0, NULL, NULL, " %lu", rec->counters->latency[i]);
+   }
+   message(stream, NULL, 0, NULL, NULL, "\n");
+
+   message(stream, NULL, 0, "DUMP", NULL,"             --- zero copy \n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tFLAG          : service publishes the record's array directly ................. (zeroCopy) : %i (=%s)\n"
+           ,rec->zeroCopy,rec->zeroCopy?"true":"false");
+
+   message(stream, NULL, 0, "DUMP", NULL,"             --- double buffered service \n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tPOINTER       : service buffers .............................. (dimServiceBuffer[0,1]) : %p, %p\n"
+           ,rec->dimServiceBuffer[0],rec->dimServiceBuffer[1]);
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tINT           : index of the buffer sent by DIM ......................... (dimServiceFront) : %i\n"
+           ,rec->dimServiceFront);
+
+   message(stream, NULL, 0, "DUMP", NULL,"             --- string transport \n");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tFLAG          : transport via strings for commands ................... (stringTransportCommand) : %i (=%s)\n"
+           ,rec->config->stringTransportCommand,rec->config->stringTransportCommand?"true":"false");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tFLAG          : transport via strings for services ................... (stringTransportService) : %i (=%s)\n"
+           ,rec->config->stringTransportService,rec->config->stringTransportService?"true":"false");
+   message(stream, NULL, 0, "DUMP", NULL,
+           "\tFLAG          : transport via strings for both .......................... (stringTransportBoth) : %i (=%s)\n"
+           ,rec->config->stringTransportBoth,rec->config->stringTransportBoth?"true":"false");
+
+   if ( false == rec->config->stringTransportCommand )
+   {
+      message(stream, NULL, 0, "DUMP", NULL,"\t.............. ommitting string transport outputs for commands\n");
+   }
+   else
+   {
+      message(stream, NULL, 0, "DUMP", NULL,
+              rec->config->dimStringTransportCommandFormat ? "%s`%s'\n":"%s%p\n",
+              "\tSTRING POINTER: STRING TRANSPORT COMMAND FORMAT ..............(dimStringTransportCommandFormat) : "
+              ,rec->config->dimStringTransportCommandFormat);
+
+      dumpFormatDescriptor(stream,
+                           "\tDESCRIPTOR    : string transport command format ... (dimStringTransportCommandFormatDescriptor) :\n",
+                           rec->config->dimStringTransportCommandFormatDescriptor);
+   }
+   if ( false == rec->config->stringTransportService )
+   {
+      message(stream, NULL, 0, "DUMP", NULL,"\t.............. ommitting string transport outputs for commands\n");
    }
-   if ( NULL != thisRecord->dimStringTransportNumberOfCommandDataTypesPerFormat)
+   else
    {
-      SAFE_FREE(thisRecord->dimStringTransportNumberOfCommandDataTypesPerFormat);
+      dumpFormatDescriptor(stream,
+                           "\tDESCRIPTOR    : string transport service format ... (dimStringTransportServiceFormatDescriptor) :\n",
+                           rec->config->dimStringTransportServiceFormatDescriptor);
    }
 
-   if ( NULL != thisRecord->dimStringTransportServiceDataTypes)
+   message(stream, NULL, 0, "DUMP", NULL,"-------------------------------------------------------------------------------------------------------------------------\n");
+   fflush(stream);
+}
+
+void clearStructRecordVariables( struct recordVariables *thisRecord )
+{
+   /* strings, format arrays, the configuration and the counters belong to recordArena, they are not freed here */
+   thisRecord->dimData = NULL;
+   thisRecord->dataSize = 0;
+   thisRecord->recordAddress = NULL;
+   thisRecord->index = 0;
+   thisRecord->dimCommandServiceID = -1;
+   thisRecord->dimServiceServiceID = -1;
+   thisRecord->dimTierType = '0';
+   thisRecord->calledFromCallback = -1;
+   thisRecord->ioScanPvt = NULL;
+   clearMailbox(&thisRecord->dimMailbox);
+   thisRecord->dimServiceExists = false;
+   thisRecord->dimCommandExists = false;
+   thisRecord->recordTypeIndex = -1;
+   thisRecord->copyDimToEpics = NULL;
+   thisRecord->copyEpicsToDim = NULL;
+   thisRecord->epicsValue = NULL;
+   thisRecord->epicsRawValue = NULL;
+   thisRecord->copyDimToEpicsArray = NULL;
+   thisRecord->copyEpicsToDimArray = NULL;
+   thisRecord->dimElementSize = 0;
+   thisRecord->dimDataReceivedSize = 0;
+   thisRecord->dimDataSendSize = 0;
+
+   thisRecord->clientServiceCallbackOk = true;
+   thisRecord->serverCommandCallbackOk = true;
+
+   thisRecord->coalesceUpdates = false;
+   thisRecord->processRequestTime = 0;
+
+   thisRecord->asyncCommand = false;
+   thisRecord->commandPending = 0;
+   thisRecord->commandReturnCode = 0;
+
+   thisRecord->callbackTime = 0;
+
+   thisRecord->zeroCopy = false;
+
+   thisRecord->dimServiceBuffer[0] = NULL;
+   thisRecord->dimServiceBuffer[1] = NULL;
+   thisRecord->dimServiceBufferSize[0] = 0;
+   thisRecord->dimServiceBufferSize[1] = 0;
+   thisRecord->dimServiceFront = 0;
+
+   thisRecord->serviceGroup = NULL;
+   thisRecord->serviceGroupOffset = 0;
+
+   if (NULL != thisRecord->counters)
    {
-      safeStringFree(&thisRecord->dimStringTransportServiceDataTypes, thisRecord->dimStringTransportNumberOfServiceFormats);
+      memset(thisRecord->counters, 0, sizeof(struct recordCounters));
    }
-   if ( NULL != thisRecord->dimCommandDataTypes)
+   if (NULL == thisRecord->config)
    {
-      safeStringFree(&thisRecord->dimCommandDataTypes, thisRecord->dimNumberOfServiceFormats);
+      return;
    }
-   thisRecord->dimCreateBoth = false;
+   thisRecord->config->dimServiceName = NULL;
+   thisRecord->config->dimServiceFormat = NULL;
+   thisRecord->config->dimCommandName = NULL;
+   thisRecord->config->dimCommandFormat = NULL;
+   thisRecord->config->dimServicesNamePrefix = NULL;
+   thisRecord->config->recordType = NULL;
+   thisRecord->config->dimDnsAddress = NULL;
+   thisRecord->config->dimDnsPort = -1;
+   thisRecord->config->dimServiceElement = -1;
+   thisRecord->config->dimServiceElementOffset = 0;
+   thisRecord->config->dimServiceStructDescriptor = NULL;
+   thisRecord->config->dimSubscription = NULL;
+   thisRecord->config->dimServiceGroupName = NULL;
+   thisRecord->config->dimServiceGroupPeriod = 0;
+   thisRecord->config->dimServiceFormatDescriptor = NULL;
+   thisRecord->config->dimCommandFormatDescriptor = NULL;
+   thisRecord->config->dimGetDefaultSuffix = NULL;
+   thisRecord->config->dimPutDefaultSuffix = NULL;
+   thisRecord->config->dimServiceScanType = -1;
+   thisRecord->config->dimServiceScanInterval = -1;
+   thisRecord->config->stringTransportCommand = false;
+   thisRecord->config->stringTransportService = false;
+   thisRecord->config->stringTransportBoth = false;
+   thisRecord->config->dimStringTransportServiceFormat = NULL;
+   thisRecord->config->dimStringTransportCommandFormat = NULL;
+   thisRecord->config->dimStringTransportServiceFormatDescriptor = NULL;
+   thisRecord->config->dimStringTransportCommandFormatDescriptor = NULL;
+   thisRecord->config->dimCreateBoth = false;
 }
 
 recordVariables* createAndInitVariables( struct dbCommon *pRecord )
 {
    int     i  = 0;
    int     found_elements=0;
-   char  **keyArray     =NULL;
-   char  **argumentArray=NULL;
-   char  **formatArray  =NULL;
+   linkToken tokens[DIMMAXIMUMNUMBEROFKEYS];
 
    char *inputOutputField =  NULL;
-   char *inputOutput;
    int   sizeOfInputOutput = 0;
    DBLINK inputOutputLink;
    struct recordVariables *thisRecord = NULL;
@@ -1435,14 +2709,26 @@ recordVariables* createAndInitVariables( struct dbCommon *pRecord )
       return NULL;
    }
 
-   /* allocate memory for 1 recordVariables*/
-   thisRecord = (recordVariables*) calloc(1, sizeof(recordVariables));
+   /* allocate memory for 1 recordVariables (hot, contiguous), its configuration and counters (cold) */
+   thisRecord = recordPoolAlloc();
    /* calloc failed  */
    if( !thisRecord)
    {
       message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "couldn't allocate memory\n");
       return NULL;
    }
+   thisRecord->config = (recordConfiguration*) recordAlloc(sizeof(recordConfiguration));
+   if( !thisRecord->config)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "couldn't allocate memory for the configuration\n");
+      return NULL;
+   }
+   thisRecord->counters = (recordCounters*) recordAlloc(sizeof(recordCounters));
+   if( !thisRecord->counters)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "couldn't allocate memory for the counters\n");
+      return NULL;
+   }
    /* copy pointer to global variables Array */
    recordVariablesArray[recordIndex] = thisRecord;
    /* set default values recordVariables */
@@ -1460,15 +2746,8 @@ recordVariables* createAndInitVariables( struct dbCommon *pRecord )
    thisRecord->recordTypeIndex = determineRecordType(pRecord);
    if (0 <= thisRecord->recordTypeIndex)
    {
-      thisRecord->recordType = malloc(sizeof(char)*(1+strlen(DIMInterfaceSupportedRecordNames[thisRecord->recordTypeIndex])));
-      if (NULL == thisRecord->recordType)
-      {
-         message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "couldn't allocate memory for record description name string ... returning NULL\n");
-         return NULL;
-      }
-      strncpy(thisRecord->recordType,
-              DIMInterfaceSupportedRecordNames[thisRecord->recordTypeIndex],
-              strlen(DIMInterfaceSupportedRecordNames[thisRecord->recordTypeIndex])+1);
+      /* shared with all records, not a copy */
+      thisRecord->config->recordType = DIMInterfaceSupportedRecordNames[thisRecord->recordTypeIndex];
    }
    /*
     * evaluate inp/out field of record 
@@ -1481,6 +2760,9 @@ recordVariables* createAndInitVariables( struct dbCommon *pRecord )
    case DIMaoRecord:
       inputOutputLink = ((struct aoRecord*)pRecord)->out;
       break;
+   case DIMwaveformRecord:
+      inputOutputLink = ((struct waveformRecord*)pRecord)->inp;
+      break;
    default:
       message(stderr,__FILE__,__LINE__,"ERROR","init_record", "record type `%s' is not (yet) supported", pRecord->rdes->name);
       return NULL;
@@ -1524,34 +2806,35 @@ recordVariables* createAndInitVariables( struct dbCommon *pRecord )
       return NULL;
    }
 
-   inputOutput = (char*) malloc(sizeof(char) * (sizeOfInputOutput+1));
-   /* check for failure */
-   if( NULL == inputOutput)
+   /* disassemble inputOutput string, slices of inputOutputField, nothing allocated */
+   found_elements = tokenizeLink(inputOutputField, tokens, DIMMAXIMUMNUMBEROFKEYS,
+                                 DIM_PRIMARY_TOKEN[0], DIM_SECONDARY_TOKEN[0], DIM_THIRD_TOKEN[0], DIM_SPACE_TOKEN[0], DIM_TOKEN_PROTECTION );
+   if (0 > found_elements)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "couldn't allocate memory ... returning NULL\n");
+      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables",
+              "could not disassemble inputOutput string (at most %i keys) ... returning NULL\n", DIMMAXIMUMNUMBEROFKEYS);
       return NULL;
    }
 
-   strcpy( &inputOutput[0], &inputOutputField[0] );
-
-   /* disassemble inputOutput string */
-   found_elements = disassembleString(inputOutput, &keyArray, &argumentArray, &formatArray,
-                                      DIM_PRIMARY_TOKEN, DIM_SECONDARY_TOKEN, DIM_THIRD_TOKEN, DIM_SPACE_TOKEN, DIM_TOKEN_PROTECTION );
-   safeStringFree(&inputOutput,sizeOfInputOutput+1);
-
    /* analyze */
    for (i = 0; i < found_elements; i++)
    {
-      switch (toupper(keyArray[i][0]))
+      char key[sizeOfInputOutput+1];
+      char argument[sizeOfInputOutput+1];
+
+      copySlice(key,      sizeof(key),      tokens[i].key,      DIM_SPACE_TOKEN[0], DIM_TOKEN_PROTECTION, DIMLINKTOKENS);
+      copySlice(argument, sizeof(argument), tokens[i].argument, DIM_SPACE_TOKEN[0], DIM_TOKEN_PROTECTION, DIMLINKTOKENS);
+
+      switch (toupper(key[0]))
       {
       case DIMTIERTYPE:
          /* check for failure: argument empty */
-         if (0 == strlen(argumentArray[i]))
+         if (0 == strlen(argument))
          {
             message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "argument of key `%s%c' is empty ... returning NULL\n",DIM_PRIMARY_TOKEN,DIMTIERTYPE);
             return NULL;
          }
-         switch(toupper(argumentArray[i][0]))
+         switch(toupper(argument[0]))
          {
          case DIMSERVER:
             thisRecord->dimTierType = DIMSERVER;
@@ -1560,22 +2843,22 @@ recordVariables* createAndInitVariables( struct dbCommon *pRecord )
             thisRecord->dimTierType = DIMCLIENT;
             break;
          default:
-            message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "`%c' is not a valid letter of the argument for %s%c ... returning NULL\n",argumentArray[i][0],DIM_PRIMARY_TOKEN,DIMTIERTYPE);
+            message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "`%c' is not a valid letter of the argument for %s%c ... returning NULL\n",argument[0],DIM_PRIMARY_TOKEN,DIMTIERTYPE);
             return NULL;
             break;
          }
          break;
       case DIMSERVERSNAMEPREFIX:
-         if (! setRecordVariablesString(&(thisRecord->dimServicesNamePrefix), argumentArray[i], "dimServicesNamePrefix", DIMSERVERSNAMEPREFIX) )
+         if (! setRecordVariablesInternedString(&(thisRecord->config->dimServicesNamePrefix), argument, "dimServicesNamePrefix", DIMSERVERSNAMEPREFIX) )
          {
             message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setRecordVariablesString() failed");
             return NULL;
          }
          break;
       case DIMSERVICE:
-         if (!keyArray[i][1])
+         if (!key[1])
          {
-            if (! setRecordVariablesString(&(thisRecord->dimServiceName), argumentArray[i], "dimServiceName", DIMSERVICE) )
+            if (! setRecordVariablesString(&(thisRecord->config->dimServiceName), argument, "dimServiceName", DIMSERVICE) )
             {
                message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setRecordVariablesString() failed");
                return NULL;
@@ -1584,21 +2867,18 @@ recordVariables* createAndInitVariables( struct dbCommon *pRecord )
          }
          else
          {
-            switch(tolower(keyArray[i][1]))
+            switch(tolower(key[1]))
             {
             case DIMFORMAT:
                {
                   /* analysis of format */
-                  if (! setRecordVariablesString(&(thisRecord->dimServiceFormat), argumentArray[i], "dimServiceFormat", '\"'))
+                  if (! setRecordVariablesInternedString(&(thisRecord->config->dimServiceFormat), argument, "dimServiceFormat", '\"'))
                   {
                      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setRecordVariablesString() failed");
                      return NULL;
                   }
 
-                  if (!disassembleFormat(thisRecord->dimServiceFormat,
-                                         &thisRecord->dimNumberOfServiceFormats,
-                                         &thisRecord->dimServiceDataTypes,
-                                         &thisRecord->dimNumberOfServiceDataTypesPerFormat))
+                  if (!disassembleFormat(thisRecord->config->dimServiceFormat, &thisRecord->config->dimServiceFormatDescriptor))
                   {
                      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "disassembleFormat() failed");
                      return NULL;
@@ -1608,42 +2888,58 @@ recordVariables* createAndInitVariables( struct dbCommon *pRecord )
                break;
             case DIMSERVICESCANINTERVAL:
                {
-                  if (0 <= thisRecord->dimServiceScanInterval)
+                  if (0 <= thisRecord->config->dimServiceScanInterval)
                   {
                      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "clients service scan interval (timeout) already set to %i, what to choose? ... returning NULL\n",
-                             thisRecord->dimServiceScanInterval);
+                             thisRecord->config->dimServiceScanInterval);
                      return NULL;
                   }
                   /* only integers are allowed, check for decimal points or commas */
-                  if (false == checkValidUnsignedInt(argumentArray[i]))
+                  if (false == checkValidUnsignedInt(argument))
                   {
                      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "clients service scan interval (timeout) is not set to a valid unsigned integer but something different: `%s' ... returning NULL\n",
-                             argumentArray[i]);
+                             argument);
                      return NULL;
                   }
                   else
                   {
-                     thisRecord->dimServiceScanInterval = atoi(argumentArray[i]);
+                     thisRecord->config->dimServiceScanInterval = atoi(argument);
                   }
                }
                break;
+            case DIMSERVICEELEMENT:
+               if (false == checkValidUnsignedInt(argument))
+               {
+                  message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "service element `%s' is not a valid unsigned integer ... returning NULL\n",
+                          argument);
+                  return NULL;
+               }
+               thisRecord->config->dimServiceElement = atoi(argument);
+               break;
+            case DIMSERVICEGROUP:
+               if (false == setServiceGroup(thisRecord, argument))
+               {
+                  message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setServiceGroup failed");
+                  return NULL;
+               }
+               break;
             case DIMSERVICESCANTYPE:
-               if (false == setCombinedClientServiceScanTypeAndInterval(thisRecord, argumentArray[i]))
+               if (false == setCombinedClientServiceScanTypeAndInterval(thisRecord, argument))
                {
                   message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setCombinedClientServiceScanTypeAndInterval failed");
                   return NULL;
                }
                break;
             default:
-               message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables()", "`%s' is not a valid Key ... returning NULL\n",keyArray[i]);
+               message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables()", "`%s' is not a valid Key ... returning NULL\n",key);
                return NULL;
-            } /*// end switch(tolower(keyArray[i][1])) */
+            } /*// end switch(tolower(key[1])) */
          }
          break;
       case DIMCOMMAND:
-         if (!keyArray[i][1])
+         if (!key[1])
          {
-            if (! setRecordVariablesString(&(thisRecord->dimCommandName), argumentArray[i], "dimCommandName", DIMCOMMAND) )
+            if (! setRecordVariablesString(&(thisRecord->config->dimCommandName), argument, "dimCommandName", DIMCOMMAND) )
             {
                message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setRecordVariablesString() failed");
                return NULL;
@@ -1652,19 +2948,16 @@ recordVariables* createAndInitVariables( struct dbCommon *pRecord )
          }
          else
          {
-            if (DIMFORMAT == tolower(keyArray[i][1]))
+            if (DIMFORMAT == tolower(key[1]))
             {
                /* analysis of format */
-               if (! setRecordVariablesString(&(thisRecord->dimCommandFormat), argumentArray[i], "dimCommandFormat", '\"'))
+               if (! setRecordVariablesInternedString(&(thisRecord->config->dimCommandFormat), argument, "dimCommandFormat", '\"'))
                {
                   message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setRecordVariablesString() failed");
                   return NULL;
                }
 
-               if (! disassembleFormat(thisRecord->dimCommandFormat,
-                                       &thisRecord->dimNumberOfCommandFormats,
-                                       &thisRecord->dimCommandDataTypes,
-                                       &thisRecord->dimNumberOfCommandDataTypesPerFormat))
+               if (! disassembleFormat(thisRecord->config->dimCommandFormat, &thisRecord->config->dimCommandFormatDescriptor))
                {
                   message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "disassembleFormat() failed");
                   return NULL;
@@ -1673,45 +2966,45 @@ recordVariables* createAndInitVariables( struct dbCommon *pRecord )
             }
             else
             {
-               message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables()", "`%s' is not a valid Key ... returning NULL\n",keyArray[i]);
+               message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables()", "`%s' is not a valid Key ... returning NULL\n",key);
                return NULL;
             }
          }
          break;
       case DIMDNSADDRESS:
          /* check for failure: string too long*/
-         if ( MAXIMUMDIMDNSADDRESSLENGTH < strlen(argumentArray[i]) )
+         if ( MAXIMUMDIMDNSADDRESSLENGTH < strlen(argument) )
          {
             message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables()", "`%s' is too long, max: %i ... returning NULL\n",
-                    keyArray[i], MAXIMUMDIMDNSADDRESSLENGTH);
+                    key, MAXIMUMDIMDNSADDRESSLENGTH);
             return NULL;
          }
-         if ( false == setCombinedDnsAddressAndPort(thisRecord, argumentArray[i]))
+         if ( false == setCombinedDnsAddressAndPort(thisRecord, argument))
          {
             message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setCombinedDnsAddressAndPort() failed");
             return NULL;
          }
          break;
       case DIMDNSPORT:
-         if (false == checkValidUnsignedInt(argumentArray[i]))
+         if (false == checkValidUnsignedInt(argument))
          {
             message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "dns port is not set to a valid unsigned integer: `%s' ... returning NULL\n",
-                    argumentArray[i]);
+                    argument);
             return NULL;
          }
          else
          {
-            thisRecord->dimDnsPort = atoi(argumentArray[i]);
+            thisRecord->config->dimDnsPort = atoi(argument);
          }
          break;
       case DIMEXTENSIONS:
-         if (keyArray[i][1])
+         if (key[1])
          {
-            switch(tolower(keyArray[i][1]))
+            switch(tolower(key[1]))
             {
             case DIMEXTENSIONSGETSUFFIX:
-               if (! setRecordVariablesString(&(thisRecord->dimGetDefaultSuffix),
-                                              argumentArray[i], "dimGetDefaultSuffix",
+               if (! setRecordVariablesInternedString(&(thisRecord->config->dimGetDefaultSuffix),
+                                              argument, "dimGetDefaultSuffix",
                                               DIMEXTENSIONSGETSUFFIX) )
                {
                   message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setRecordVariablesString() failed");
@@ -1719,8 +3012,8 @@ recordVariables* createAndInitVariables( struct dbCommon *pRecord )
                }
                break;
             case DIMEXTENSIONSPUTSUFFIX:
-               if (! setRecordVariablesString(&(thisRecord->dimPutDefaultSuffix),
-                                              argumentArray[i], "dimPutDefaultSuffix",
+               if (! setRecordVariablesInternedString(&(thisRecord->config->dimPutDefaultSuffix),
+                                              argument, "dimPutDefaultSuffix",
                                               DIMEXTENSIONSPUTSUFFIX) )
                {
                   message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setRecordVariablesString() failed");
@@ -1729,70 +3022,73 @@ recordVariables* createAndInitVariables( struct dbCommon *pRecord )
                }
                break;
             case DIMEXTENSIONSCREATE:
-               if (keyArray[i][2])
+               if (key[2])
                {
-                  switch(tolower(keyArray[i][2]))
+                  switch(tolower(key[2]))
                   {
                   case DIMEXTENSIONSCREATEBOTH:
-                     thisRecord->dimCreateBoth = true;
+                     thisRecord->config->dimCreateBoth = true;
                      break;
                   default:
                      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables()", "%c%c`%s' is not a valid extension string transport Key ... returning NULL\n",
-                             DIMEXTENSIONS,DIMEXTENSIONSCREATE,&keyArray[i][2]);
+                             DIMEXTENSIONS,DIMEXTENSIONSCREATE,&key[2]);
                      return NULL;
                      break;
                   }
                }
                break;
+            case DIMEXTENSIONSCOALESCE:
+               thisRecord->coalesceUpdates = true;
+               break;
+            case DIMEXTENSIONSASYNCCOMMAND:
+               thisRecord->asyncCommand = true;
+               break;
+            case DIMEXTENSIONSZEROCOPY:
+               thisRecord->zeroCopy = true;
+               break;
             case DIMEXTENSIONSTRINGTRANSPORT:
-               if (keyArray[i][2])
+               if (key[2])
                {
-                  switch(tolower(keyArray[i][2]))
+                  switch(tolower(key[2]))
                   {
                   case DIMEXTENSIONSTRINGTRANSPORTSERVICE:
-                     if (! setRecordVariablesString(&(thisRecord->dimStringTransportServiceFormat),
-                                                    argumentArray[i], "dimStringTransportServiceFormat",
+                     if (! setRecordVariablesInternedString(&(thisRecord->config->dimStringTransportServiceFormat),
+                                                    argument, "dimStringTransportServiceFormat",
                                                     DIMEXTENSIONS))
                      {
                         message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setRecordVariablesString() failed");
                         return NULL;
 
                      }
-                     if (! disassembleFormat(thisRecord->dimStringTransportServiceFormat,
-                                             &thisRecord->dimStringTransportNumberOfServiceFormats,
-                                             &thisRecord->dimStringTransportServiceDataTypes,
-                                             &thisRecord->dimStringTransportNumberOfServiceDataTypesPerFormat))
+                     if (! disassembleFormat(thisRecord->config->dimStringTransportServiceFormat, &thisRecord->config->dimStringTransportServiceFormatDescriptor))
                      {
                         message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "disassembleFormat() failed");
                         return NULL;
                      }
-                     thisRecord->stringTransportService = true;
+                     thisRecord->config->stringTransportService = true;
                      break;
                   case DIMEXTENSIONSTRINGTRANSPORTCOMMAND:
-                     if (! setRecordVariablesString(&(thisRecord->dimStringTransportCommandFormat),
-                                                    argumentArray[i], "dimStringTransportCommandFormat",
+                     if (! setRecordVariablesInternedString(&(thisRecord->config->dimStringTransportCommandFormat),
+                                                    argument, "dimStringTransportCommandFormat",
                                                     DIMEXTENSIONS))
                      {
                         message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setRecordVariablesString() failed");
                         return NULL;
 
                      }
-                     if (! disassembleFormat(thisRecord->dimStringTransportCommandFormat,
-                                             &thisRecord->dimStringTransportNumberOfCommandFormats,
-                                             &thisRecord->dimStringTransportCommandDataTypes,
-                                             &thisRecord->dimStringTransportNumberOfCommandDataTypesPerFormat))
+                     if (! disassembleFormat(thisRecord->config->dimStringTransportCommandFormat, &thisRecord->config->dimStringTransportCommandFormatDescriptor))
                      {
                         message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "disassembleFormat() failed");
                         return NULL;
                      }
-                     thisRecord->stringTransportCommand = true;
+                     thisRecord->config->stringTransportCommand = true;
                      break;
                   case DIMEXTENSIONSTRINGTRANSPORTBOTH:
-                     thisRecord->stringTransportBoth = true;
+                     thisRecord->config->stringTransportBoth = true;
                      break;
                   default:
                      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables()", "%c%c`%s' is not a valid extension string transport Key ... returning NULL\n",
-                             DIMEXTENSIONS,DIMEXTENSIONSTRINGTRANSPORT,&keyArray[i][2]);
+                             DIMEXTENSIONS,DIMEXTENSIONSTRINGTRANSPORT,&key[2]);
                      return NULL;
                      break;
                   }
@@ -1806,344 +3102,1107 @@ recordVariables* createAndInitVariables( struct dbCommon *pRecord )
                break;
             default:
                message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables()", "%c`%s' is not a valid extension Key ... returning NULL\n",
-                       DIMEXTENSIONS,&keyArray[i][1]);
+                       DIMEXTENSIONS,&key[1]);
                return NULL;
                break;
             }
          }
-         else
+         else
+         {
+            message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables()", "%c is an incomplete key ... returning NULL\n",
+                    DIMEXTENSIONS);
+            return NULL;
+         }
+         break;
+      default:
+         message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables()", "`%s' is not a valid Key ... returning NULL\n",key);
+         return NULL;
+         break;
+      }
+      /*
+      // end:  switch (toupper(key[0]))
+       */
+   }
+   /*
+   // end: for (i = 0; i < found_elements; i++)
+    */
+   /* ************************************************************************************************************** */
+
+   /* ************************************************************************************************************** */
+   /* consistency checks, default settings, dependencies */
+
+   /* TODO: (maybe later in this code) checks for consistency of format='C[:N]' and stringTransport
+    * resulting in stringTransport... = true, 
+    * also Xsb option to be evaluated */
+   /*
+    * TODO:check for string transport (record specific)??
+    * */
+
+
+   /* settings:
+    * 
+    * CLIENT for service service 
+    * - if the dim service type scan type is not set (=0) 
+    *   (instead of MONITORED (=2), TIMED (=4), 
+    *   (ONCE_ONLY (=1) does not make sense))
+    * 
+    *   => MONITORED is set as default value
+    */
+   if (DIMCLIENT == thisRecord->dimTierType)
+   {
+      if (0 >= thisRecord->config->dimServiceScanType)
+      {
+         thisRecord->config->dimServiceScanType = MONITORED;
+         if (0 > thisRecord->config->dimServiceScanInterval)
+         {
+            thisRecord->config->dimServiceScanInterval=0;
+         }
+      }
+   }
+
+   /* check:
+    * 
+    * CLIENT for service service 
+    * - if the dim service type scan type is set to TIMED 
+    *   the scan interval has to be different from 0
+    */
+   if (DIMCLIENT == thisRecord->dimTierType)
+   {
+      if (TIMED == thisRecord->config->dimServiceScanType)
+      {
+         if (0 >= thisRecord->config->dimServiceScanInterval )
+         {
+            message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "mandatory clients service scan interval (timeout) is not set for mode MONITORED... returning NULL\n");
+            return NULL;
+         }
+      }
+   }
+
+   /* settings:
+    * 
+    * SERVER: autogenerate missing services 
+    * - in case only one service is defined: switchable with Xoption create both
+    *   else automatically create both services 
+    * - names 
+    * 	- if only one name is specified, append (DEFAULT)SUFFIXES
+    * 	- if both are missing use recordname, append (DEFAULT)SUFFIXES
+    * - the same also for formats
+    */
+
+   if (DIMSERVER == thisRecord->dimTierType)
+   {
+      if (true == thisRecord->config->dimCreateBoth || ((NULL == thisRecord->config->dimCommandName) && (NULL == thisRecord->config->dimServiceName)))
+      {
+         if ((!thisRecord->config->dimCommandName) || (!thisRecord->config->dimServiceName))
+         {
+            if (!supplementServersNamesAndFormats(thisRecord))
+            {
+               message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "supplementServersNamesAndFormats() failed");
+               return NULL;
+            }
+         }
+      }
+   }
+
+   /* check:
+    *  
+    * CLIENT: 
+    * - if at least one Service name is set 
+    */
+
+   if (DIMCLIENT == thisRecord->dimTierType)
+   {
+      if((!thisRecord->config->dimCommandName) && (!thisRecord->config->dimServiceName))
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "You have to at least specify  either a Command, via `%s%c%s', or a Service, via `%s%c%s' ... returning NULL\n",
+                 DIM_PRIMARY_TOKEN, DIMCOMMAND, DIM_SECONDARY_TOKEN, DIM_PRIMARY_TOKEN, DIMSERVICE, DIM_SECONDARY_TOKEN);
+         return NULL;
+      }
+   }
+
+   /* settings:
+    * 
+    * SERVER/CLIENT: Services prefix
+    * - if set serversPrefix,
+    *   then add it in front of the service names 
+    *   in the form prefix/name, if name exists
+    *   (where the seperator '/' can be chosen by DIMSERVICESPREFIXSEPARATOR)
+    */
+
+   if ( false == addServersPrefix(thisRecord) )
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "addServersPrefix() failed ... returning NULL\n");
+      return NULL;
+   }
+
+   /* settings:
+    * 
+    * CLIENT: retrieve format
+    *  - if format not set, 
+    *    retrieve it via  
+    *    - id = dic_info/cmnd_service, 
+    *    - get_dic_format(id)
+    *    - release(id)
+    * TODO: possible also for Commands?
+    */
+   if ( false == retrieveAndSetClientServicesFormat(thisRecord) )
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "retrieveAndSetClientServicesFormat() failed ... returning NULL\n");
+      return NULL;
+   }
+
+   /* settings:
+    * 
+    * SERVER: 
+    * - if server and no format is specified, set default datatypes,
+    *   record specificly defined via DIMrecordDEFAULTDATATYPE 
+    *  (record= AI,AO,STRING, ..)
+   */
+   if (false == setServersDefaultDataFormat(thisRecord))
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setServersDefaultDataFormat() failed ... returning NULL\n");
+      return NULL;
+   }
+
+   /* settings:
+    *
+    * CLIENT: element of a struct service (@Se), 
+    *  - the record's format becomes the one of the element
+    */
+   if (false == selectServiceElement(thisRecord))
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "selectServiceElement() failed ... returning NULL\n");
+      return NULL;
+   }
+
+
+   /* check:
+    * 
+    * CLIENT/SERVER: identical format types
+    *  - if both, service and command, are set
+    *  	- check if format types of service and command are identical
+    * TODO:  - check also in case of string transport mode
+    */
+   if (false == checkConsistencyFormatTypes(thisRecord))
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "checkConsistencyFormatTypes() failed\n");
+      return NULL;
+   }
+
+   /* settings:
+    *
+    * CLIENT/SERVER: arrays without number of elements (e.g. `F'), 
+    *  - waveform: NELM elements
+    */
+   if (false == setArrayDefaultNumberOfElements(thisRecord))
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setArrayDefaultNumberOfElements() failed ... returning NULL\n");
+      return NULL;
+   }
+
+   /*
+    * determine needed datasize 
+    */
+   thisRecord->dataSize = determineDataSize(thisRecord);
+   if ( 0 == thisRecord->dataSize)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "determineDataSize() failed\n");
+      return NULL;
+   }
+
+   /*
+    *  type specific allocation 
+    * 
+    * (those relies upon previous check: check if service and command if formats are identical). s.a.
+    */
+
+   thisRecord->dimData = malloc( thisRecord->dataSize );
+   if ( NULL == thisRecord->dimData)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "couldn't allocate memory for dimData ... returning NULL\n");
+      return NULL;
+   }
+
+   /*
+    * served services (not zero copy): front/back buffer,
+    * process() writes dimData (back), DIM sends the front buffer (s. swapServiceBuffers())
+    */
+   if (DIMSERVER == thisRecord->dimTierType && true == thisRecord->dimServiceExists && false == thisRecord->zeroCopy)
+   {
+      thisRecord->dimServiceBuffer[0] = thisRecord->dimData;
+      thisRecord->dimServiceBuffer[1] = calloc(1, thisRecord->dataSize);
+      if ( NULL == thisRecord->dimServiceBuffer[1])
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "couldn't allocate memory for service's front buffer ... returning NULL\n");
+         return NULL;
+      }
+      thisRecord->dimServiceFront = 1;
+   }
+
+   /*
+    * mailbox for data received from DIM:
+    * written by dimCallback(), read by process()
+    */
+   if (false == initMailbox(&thisRecord->dimMailbox, thisRecord->dataSize))
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "initMailbox() failed ... returning NULL\n");
+      return NULL;
+   }
+
+   /*
+    * record specific consistency checks:
+    */
+
+   if (false == checkConsistencyRecordSpecific(thisRecord))
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "checkConsistencyRecordSpecific() failed\n");
+      return NULL;
+   }
+
+   /*
+    * set callback flag 
+    */
+   thisRecord->calledFromCallback = 0;
+
+   /* *************************************************************************************************************** */
+
+   return thisRecord;
+}
+
+bool retrieveAndSetClientServicesFormat(struct recordVariables *thisRecord)
+{
+   char *format = NULL;
+
+   if (DIMCLIENT == thisRecord->dimTierType)
+   {
+      if ( thisRecord->dimServiceExists )
+      {
+         if (NULL == thisRecord->config->dimServiceFormat)
+         {
+            if (false == getServiceFormat(&format, thisRecord))
+            {
+               message(stderr,__FILE__,__LINE__,"ERROR","retrieveAndSetClientServicesFormat", "getServiceFormat() failed\n");
+               return false;
+            }
+
+            if (NULL == setRecordVariablesInternedString(&(thisRecord->config->dimServiceFormat), format, "dimServiceFormat", 0))
+            {
+               message(stderr,__FILE__,__LINE__,"ERROR","retrieveAndSetClientServicesFormat", "setRecordVariablesString failed\n");
+               SAFE_FREE(format);
+               return false;
+            }
+            SAFE_FREE(format);
+            if (false == disassembleFormat(thisRecord->config->dimServiceFormat, &thisRecord->config->dimServiceFormatDescriptor))
+            {
+               message(stderr,__FILE__,__LINE__,"ERROR","retrieveAndSetClientServicesFormat", "disassembleFormat() failed");
+               return false;
+            }
+         }
+      }
+      if ( thisRecord->dimCommandExists )
+      {
+         if (NULL == thisRecord->config->dimCommandFormat)
          {
-            message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables()", "%c is an incomplete key ... returning NULL\n",
-                    DIMEXTENSIONS);
-            return NULL;
+            if (false == getCommandFormat(&format, thisRecord))
+            {
+               message(stderr,__FILE__,__LINE__,"ERROR","retrieveAndSetClientServicesFormat", "getCommandFormat() failed ... returning NULL\n");
+               return false;
+            }
+
+            if (NULL == setRecordVariablesInternedString(&(thisRecord->config->dimCommandFormat),
+                                                  format, "dimCommandFormat", 0))
+            {
+               message(stderr,__FILE__,__LINE__,"ERROR","retrieveAndSetClientServicesFormat", "setRecordVariablesString failed\n");
+               SAFE_FREE(format);
+               return false;
+            }
+            SAFE_FREE(format);
+            if (false == disassembleFormat(thisRecord->config->dimCommandFormat, &thisRecord->config->dimCommandFormatDescriptor))
+            {
+               message(stderr,__FILE__,__LINE__,"ERROR","retrieveAndSetClientServicesFormat", "disassembleFormat() failed");
+               return false;
+            }
          }
-         break;
-      default:
-         message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables()", "`%s' is not a valid Key ... returning NULL\n",keyArray[i]);
-         return NULL;
-         break;
       }
-      /*
-      // end:  switch (toupper(keyArray[i][0]))
-       */
    }
+   return true;
+}
+
+void dimDnsNodeKey(char node[], const char dnsAddress[])
+{
    /*
-   // end: for (i = 0; i < found_elements; i++)
+    * DNS node (at most MAXIMUMDIMDNSADDRESSLENGTH characters) client services are keyed on
+    * in the format cache and the pre-resolution:
+    * the record's @D without port, else the client's DNS node captured once,
+    * before the first record is initialised (init(after=0))
     */
-   /* ************************************************************************************************************** */
+   if (NULL != dnsAddress && 0 < strlen(dnsAddress))
+   {
+      strncpy(node, dnsAddress, MAXIMUMDIMDNSADDRESSLENGTH);
+      node[MAXIMUMDIMDNSADDRESSLENGTH] = '\0';
+      if (NULL != strchr(node, ':'))
+      {
+         *strchr(node, ':') = '\0';
+      }
+      return;
+   }
+   if (false == dimClientDefaultNodeKnown)
+   {
+      dic_get_dns_node(dimClientDefaultNode);
+      dimClientDefaultNodeKnown = true;
+   }
+   strncpy(node, dimClientDefaultNode, MAXIMUMDIMDNSADDRESSLENGTH);
+   node[MAXIMUMDIMDNSADDRESSLENGTH] = '\0';
+}
 
-   safeFreeOfDisassemblyStringArrays(found_elements,keyArray,argumentArray,formatArray);
+bool getServiceFormat(char **serviceFormat, struct recordVariables *thisRecord)
+{
+   assert(NULL != thisRecord->config->dimServiceName);
+   return getFormat(serviceFormat, thisRecord->config->dimServiceName, thisRecord);
+}
 
-   /* ************************************************************************************************************** */
-   /* consistency checks, default settings, dependencies */
+bool getCommandFormat(char **commandFormat, struct recordVariables *thisRecord)
+{
+   /* TODO: does this work ??? (format of a command via dic_info_service) */
+   assert(NULL != thisRecord->config->dimCommandName);
+   return getFormat(commandFormat, thisRecord->config->dimCommandName, thisRecord);
+}
 
-   /* TODO: (maybe later in this code) checks for consistency of format='C[:N]' and stringTransport
-    * resulting in stringTransport... = true, 
-    * also Xsb option to be evaluated */
+bool getFormat(char **format, char *name, struct recordVariables *thisRecord)
+{
    /*
-    * TODO:check for string transport (record specific)??
-    * */
+    * format of service/command `name',
+    * - from the format cache, if set (dimSetFormatCache) and known,
+    * - otherwise from the server (dic_get_format), then added to the cache
+    * *format is allocated, to be freed by the caller
+    */
+   char node[MAXIMUMDIMDNSADDRESSLENGTH+1] = {'\0'};
+   struct formatCacheEntry *entry = NULL;
 
+   /* DNS node the service is keyed on, as in preResolveInputOutput() */
+   dimDnsNodeKey(node, thisRecord->config->dimDnsAddress);
 
-   /* settings:
-    * 
-    * CLIENT for service service 
-    * - if the dim service type scan type is not set (=0) 
-    *   (instead of MONITORED (=2), TIMED (=4), 
-    *   (ONCE_ONLY (=1) does not make sense))
-    * 
-    *   => MONITORED is set as default value
+   entry = findFormatCacheEntry(name, node);
+   if (NULL != entry)
+   {
+      entry->used = true;
+      return (NULL != setHeapString(format, entry->format, "format", 0));
+   }
+
+   if (false == queryDimFormat(format, name))
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","getFormat", "could not retrieve format of `%s' (DNS node `%s')\n", name, node);
+      return false;
+   }
+
+   if (NULL != formatCacheFile)
+   {
+      entry = addFormatCacheEntry(name, node, *format);
+      if (NULL != entry)
+      {
+         entry->used = true;
+      }
+   }
+   return true;
+}
+
+void getDimFormatCallback(long *tag,  void *data,  int *size)
+{
+   /* ONCE_ONLY answer of queryDimFormats(),
+    * the fill address is passed if the service is not available */
+   struct formatQuery *query = (struct formatQuery*) *tag;
+   char *format = NULL;
+
+   if (data != &query->fill)
+   {
+      format = dic_get_format(0);
+      if (NULL != format && strlen(format))
+      {
+         query->format = strdup(format);
+      }
+   }
+   /* the last answer of the batch wakes up the waiting thread */
+   if (0 == __sync_sub_and_fetch(query->outstanding, 1))
+   {
+      epicsEventSignal(query->done);
+   }
+}
+
+bool queryDimFormats(struct formatQuery queries[], int numberOfQueries)
+{
+   /*
+    * all requests are sent at once, the answers are collected concurrently,
+    * waits at most DIMFORMATTIMEOUT seconds for all of them,
+    * queries[i].format is allocated for each answered query (NULL otherwise)
     */
-   if (DIMCLIENT == thisRecord->dimTierType)
+   epicsEventId done = NULL;
+   int outstanding = numberOfQueries;
+   int i = 0;
+
+   if (0 >= numberOfQueries)
+   {
+      return true;
+   }
+   done = epicsEventCreate(epicsEventEmpty);
+   if (NULL == done)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","queryDimFormats", "could not create event\n");
+      return false;
+   }
+
+   for (i = 0; i < numberOfQueries; i++)
    {
-      if (0 >= thisRecord->dimServiceScanType)
+      queries[i].done = done;
+      queries[i].outstanding = &outstanding;
+      queries[i].format = NULL;
+      queries[i].id = dic_info_service(queries[i].name, ONCE_ONLY, DIMFORMATTIMEOUT, 0, 0,
+                                       getDimFormatCallback, (long) &queries[i], &queries[i].fill, sizeof(queries[i].fill));
+      if (0 == queries[i].id)
       {
-         thisRecord->dimServiceScanType = MONITORED;
-         if (0 > thisRecord->dimServiceScanInterval)
+         message(stderr,__FILE__,__LINE__,"ERROR","queryDimFormats", "dic_info_service for `%s' failed\n", queries[i].name);
+         if (0 == __sync_sub_and_fetch(&outstanding, 1))
          {
-            thisRecord->dimServiceScanInterval=0;
+            epicsEventSignal(done);
          }
       }
    }
 
-   /* check:
-    * 
-    * CLIENT for service service 
-    * - if the dim service type scan type is set to TIMED 
-    *   the scan interval has to be different from 0
-    */
-   if (DIMCLIENT == thisRecord->dimTierType)
+   if (epicsEventWaitOK != epicsEventWaitWithTimeout(done, DIMFORMATTIMEOUT))
+   {
+      message(stderr,__FILE__,__LINE__,"WARNING","queryDimFormats", "%i of %i service(s) did not answer within %i s\n",
+              outstanding, numberOfQueries, DIMFORMATTIMEOUT);
+   }
+   /* no further callbacks after the release */
+   for (i = 0; i < numberOfQueries; i++)
+   {
+      if (0 != queries[i].id)
+      {
+         dic_release_service(queries[i].id);
+      }
+   }
+   epicsEventDestroy(done);
+   return true;
+}
+
+bool queryDimFormat(char **format, char *name)
+{
+   /* one round trip to the server of `name' */
+   struct formatQuery query;
+
+   memset(&query, 0, sizeof(query));
+   query.name = name;
+   if (false == queryDimFormats(&query, 1) || NULL == query.format)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","queryDimFormat", "empty format string for `%s'\n", name);
+      return false;
+   }
+   *format = query.format;
+   return true;
+}
+
+struct formatCacheEntry* findFormatCacheEntry(char *name, char *node)
+{
+   char key[MAXIMUMDIMFORMATLENGTH] = {'\0'};
+   GPHENTRY *hashEntry = NULL;
+
+   if (NULL == formatCacheTable)
+   {
+      return NULL;
+   }
+   snprintf(key, MAXIMUMDIMFORMATLENGTH, "%s%s%s", name, DIMFORMATCACHEKEYSEPARATOR, node);
+   hashEntry = gphFind(formatCacheTable, key, NULL);
+   if (NULL == hashEntry)
    {
-      if (TIMED == thisRecord->dimServiceScanType)
+      return NULL;
+   }
+   return (struct formatCacheEntry*) hashEntry->userPvt;
+}
+
+struct formatCacheEntry* addFormatCacheEntry(char *name, char *node, char *format)
+{
+   /* adds or updates an entry of the format cache */
+   char key[MAXIMUMDIMFORMATLENGTH] = {'\0'};
+   GPHENTRY *hashEntry = NULL;
+   struct formatCacheEntry *entry = findFormatCacheEntry(name, node);
+
+   if (NULL != entry)
+   {
+      if (0 != strcmp(entry->format, format))
       {
-         if (0 >= thisRecord->dimServiceScanInterval )
+         SAFE_FREE(entry->format);
+         if (NULL == setHeapString(&entry->format, format, "format cache format", 0))
          {
-            message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "mandatory clients service scan interval (timeout) is not set for mode MONITORED... returning NULL\n");
             return NULL;
          }
+         entry->changed = true;
       }
+      return entry;
    }
 
-   /* settings:
-    * 
-    * SERVER: autogenerate missing services 
-    * - in case only one service is defined: switchable with Xoption create both
-    *   else automatically create both services 
-    * - names 
-    * 	- if only one name is specified, append (DEFAULT)SUFFIXES
-    * 	- if both are missing use recordname, append (DEFAULT)SUFFIXES
-    * - the same also for formats
+   if (NULL == formatCacheTable)
+   {
+      gphInitPvt(&formatCacheTable, 512);
+   }
+   if(0 == formatCacheIndex%MAX_DIMFormatCacheEntries)
+   {
+      formatCacheEntries = (struct formatCacheEntry**) realloc( formatCacheEntries,
+                           sizeof(struct formatCacheEntry*) * (formatCacheIndex + MAX_DIMFormatCacheEntries));
+      if (NULL == formatCacheEntries)
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","addFormatCacheEntry", "couldn't (re)allocate memory for format cache\n");
+         formatCacheIndex = 0;
+         return NULL;
+      }
+   }
+
+   entry = (struct formatCacheEntry*) calloc(1, sizeof(struct formatCacheEntry));
+   if (NULL == entry)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","addFormatCacheEntry", "couldn't allocate memory for format cache entry\n");
+      return NULL;
+   }
+   snprintf(key, MAXIMUMDIMFORMATLENGTH, "%s%s%s", name, DIMFORMATCACHEKEYSEPARATOR, node);
+   if (   NULL == setHeapString(&entry->key,    key,    "format cache key", 0)
+       || NULL == setHeapString(&entry->name,   name,   "format cache name", 0)
+       || NULL == setHeapString(&entry->node,   node,   "format cache node", 0)
+       || NULL == setHeapString(&entry->format, format, "format cache format", 0))
+   {
+      return NULL;
+   }
+   entry->changed = true;
+
+   /* gphAdd does not copy the key */
+   hashEntry = gphAdd(formatCacheTable, entry->key, NULL);
+   if (NULL == hashEntry)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","addFormatCacheEntry", "gphAdd() failed for `%s'\n", key);
+      return NULL;
+   }
+   hashEntry->userPvt = entry;
+   formatCacheEntries[formatCacheIndex++] = entry;
+   return entry;
+}
+
+bool readFormatCache(char *fileName)
+{
+   /* lines: node service format, '#' comments */
+   char line[3*MAXIMUMDIMFORMATLENGTH] = {'\0'};
+   char node[MAXIMUMDIMFORMATLENGTH]   = {'\0'};
+   char name[MAXIMUMDIMFORMATLENGTH]   = {'\0'};
+   char format[MAXIMUMDIMFORMATLENGTH] = {'\0'};
+   struct formatCacheEntry *entry = NULL;
+   int lineNumber = 0;
+   FILE *file = fopen(fileName, "r");
+
+   if (NULL == file)
+   {
+      /* first start, written after iocInit */
+      message(stdout,NULL,0,"INFO","readFormatCache", "format cache `%s' not (yet) existing\n", fileName);
+      return true;
+   }
+   while (NULL != fgets(line, sizeof(line), file))
+   {
+      lineNumber++;
+      if ('#' == line[0] || '\n' == line[0])
+      {
+         continue;
+      }
+      if (3 != sscanf(line, "%9999s %9999s %9999s", node, name, format))
+      {
+         message(stderr,__FILE__,__LINE__,"WARNING","readFormatCache", "%s:%i: invalid line, skipped\n", fileName, lineNumber);
+         continue;
+      }
+      entry = addFormatCacheEntry(name, node, format);
+      if (NULL == entry)
+      {
+         fclose(file);
+         return false;
+      }
+      entry->changed = false;
+   }
+   fclose(file);
+   return true;
+}
+
+bool writeFormatCache(char *fileName)
+{
+   /* written to a temporary file first, replacing the cache at once */
+   char temporaryName[MAXIMUMDIMFORMATLENGTH] = {'\0'};
+   FILE *file = NULL;
+   int i = 0;
+
+   snprintf(temporaryName, MAXIMUMDIMFORMATLENGTH, "%s.tmp", fileName);
+   file = fopen(temporaryName, "w");
+   if (NULL == file)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","writeFormatCache", "could not open `%s': %s\n", temporaryName, strerror(errno));
+      return false;
+   }
+   fprintf(file, "# caDIMInterface format cache: node service format\n");
+   for (i = 0; i < formatCacheIndex; i++)
+   {
+      fprintf(file, "%s %s %s\n", formatCacheEntries[i]->node, formatCacheEntries[i]->name, formatCacheEntries[i]->format);
+   }
+   if (0 != fclose(file) || 0 != rename(temporaryName, fileName))
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","writeFormatCache", "could not write `%s': %s\n", fileName, strerror(errno));
+      return false;
+   }
+   return true;
+}
+
+static bool dnsNodeListContains(const char list[], const char node[])
+{
+   /* node is one of the comma separated nodes of list */
+   size_t length = strlen(node);
+   const char *pNode = list;
+
+   if (0 == length)
+   {
+      return false;
+   }
+   while (NULL != (pNode = strstr(pNode, node)))
+   {
+      if ((pNode == list || ',' == pNode[-1]) && ('\0' == pNode[length] || ',' == pNode[length]))
+      {
+         return true;
+      }
+      pNode += length;
+   }
+   return false;
+}
+
+int invalidateFormatRecords(struct formatCacheEntry *entry)
+{
+   /*
+    * the format of the client service/command of entry has changed since the records took it:
+    * subscribers of the service get COMM/INVALID on every update (s. dimSubscriptionCallback()),
+    * records calling the command are deactivated,
+    * returns the number of records affected
     */
+   char node[MAXIMUMDIMDNSADDRESSLENGTH+1] = {'\0'};
+   int affected = 0;
+   int i = 0, j = 0;
 
-   if (DIMSERVER == thisRecord->dimTierType)
+   for (i = 0; i < recordIndex; i++)
    {
-      if (true == thisRecord->dimCreateBoth || ((NULL == thisRecord->dimCommandName) && (NULL == thisRecord->dimServiceName)))
+      struct recordVariables *rec = recordVariablesArray[i];
+      struct dbCommon *pRecord = NULL;
+
+      if (NULL == rec || NULL == rec->config || DIMCLIENT != rec->dimTierType)
+      {
+         continue;
+      }
+      dimDnsNodeKey(node, rec->config->dimDnsAddress);
+      if (0 != strcmp(node, entry->node))
       {
-         if ((!thisRecord->dimCommandName) || (!thisRecord->dimServiceName))
+         continue;
+      }
+      pRecord = (struct dbCommon*) rec->recordAddress;
+
+      if (NULL != rec->config->dimServiceName && 0 == strcmp(rec->config->dimServiceName, entry->name)
+          && NULL != rec->config->dimSubscription)
+      {
+         struct dimSubscription *subscription = rec->config->dimSubscription;
+         for (j = 0; j < subscription->numberOfSubscribers; j++)
          {
-            if (!supplementServersNamesAndFormats(thisRecord))
+            if (rec == subscription->subscribers[j].record)
             {
-               message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "supplementServersNamesAndFormats() failed");
-               return NULL;
+               subscription->subscribers[j].formatChanged = true;
             }
          }
+         rec->clientServiceCallbackOk = false;
+         notifyRecord(rec);
+         message(stderr,__FILE__,__LINE__,"ERROR","invalidateFormatRecords", "record `%s' set INVALID until restart\n", pRecord->name);
+         affected++;
+      }
+      else if (NULL != rec->config->dimCommandName && 0 == strcmp(rec->config->dimCommandName, entry->name))
+      {
+         dbScanLock(pRecord);
+         errorDeactivateRecord(pRecord, __LINE__, "invalidateFormatRecords", "format of command `%s' changed", entry->name);
+         dbScanUnlock(pRecord);
+         affected++;
       }
    }
+   return affected;
+}
 
-   /* check:
-    *  
-    * CLIENT: 
-    * - if at least one Service name is set 
+void refreshFormatCache(void *arg)
+{
+   /*
+    * background thread started in init(after=1):
+    * stores new entries, then requests the formats used by the records again in one batch,
+    * only those of the DNS node(s) the client is connected to:
+    * the client's DNS node is not switched while the subscriptions use it,
+    * a changed format is stored for the next start, the records using the old one
+    * are set INVALID or deactivated (s. invalidateFormatRecords())
     */
+   int i = 0;
+   int numberOfQueries = 0;
+   int changed = 0;
+   char currentNode[MAXIMUMDIMDNSADDRESSLENGTH+1] = {'\0'};
+   struct formatQuery *queries = NULL;
+   struct formatCacheEntry **entries = NULL;
 
-   if (DIMCLIENT == thisRecord->dimTierType)
+   writeFormatCache(formatCacheFile);
+
+   if (0 == formatCacheIndex)
    {
-      if((!thisRecord->dimCommandName) && (!thisRecord->dimServiceName))
-      {
-         message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "You have to at least specify  either a Command, via `%s%c%s', or a Service, via `%s%c%s' ... returning NULL\n",
-                 DIM_PRIMARY_TOKEN, DIMCOMMAND, DIM_SECONDARY_TOKEN, DIM_PRIMARY_TOKEN, DIMSERVICE, DIM_SECONDARY_TOKEN);
-         return NULL;
-      }
+      return;
+   }
+   queries = (struct formatQuery*) calloc(formatCacheIndex, sizeof(struct formatQuery));
+   entries = (struct formatCacheEntry**) calloc(formatCacheIndex, sizeof(struct formatCacheEntry*));
+   if (NULL == queries || NULL == entries)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","refreshFormatCache", "couldn't allocate memory for %i queries\n", formatCacheIndex);
+      SAFE_FREE(queries);
+      SAFE_FREE(entries);
+      return;
    }
 
-   /* settings:
-    * 
-    * SERVER/CLIENT: Services prefix
-    * - if set serversPrefix,
-    *   then add it in front of the service names 
-    *   in the form prefix/name, if name exists
-    *   (where the seperator '/' can be chosen by DIMSERVICESPREFIXSEPARATOR)
-    */
-
-   if ( false == addServersPrefix(thisRecord) )
+   dic_get_dns_node(currentNode);
+   for (i = 0; i < formatCacheIndex; i++)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "addServersPrefix() failed ... returning NULL\n");
-      return NULL;
+      struct formatCacheEntry *entry = formatCacheEntries[i];
+      if (false == entry->used || false == dnsNodeListContains(currentNode, entry->node))
+      {
+         continue;
+      }
+      queries[numberOfQueries].name = entry->name;
+      queries[numberOfQueries].node = entry->node;
+      entries[numberOfQueries++] = entry;
    }
+   queryDimFormats(queries, numberOfQueries);
 
-   /* settings:
-    * 
-    * CLIENT: retrieve format
-    *  - if format not set, 
-    *    retrieve it via  
-    *    - id = dic_info/cmnd_service, 
-    *    - get_dic_format(id)
-    *    - release(id)
-    * TODO: possible also for Commands?
-    */
-   if ( false == retrieveAndSetClientServicesFormat(thisRecord) )
+   for (i = 0; i < numberOfQueries; i++)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "retrieveAndSetClientServicesFormat() failed ... returning NULL\n");
-      return NULL;
+      struct formatCacheEntry *entry = entries[i];
+      if (NULL != queries[i].format && 0 != strcmp(queries[i].format, entry->format))
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","refreshFormatCache", "format of `%s' changed from `%s' to `%s' (used at next start)\n",
+                 entry->name, entry->format, queries[i].format);
+         invalidateFormatRecords(entry);
+         addFormatCacheEntry(entry->name, entry->node, queries[i].format);
+         changed++;
+      }
+      SAFE_FREE(queries[i].format);
    }
+   SAFE_FREE(queries);
+   SAFE_FREE(entries);
 
-   /* settings:
-    * 
-    * SERVER: 
-    * - if server and no format is specified, set default datatypes,
-    *   record specificly defined via DIMrecordDEFAULTDATATYPE 
-    *  (record= AI,AO,STRING, ..)
-   */
-   if (false == setServersDefaultDataFormat(thisRecord))
+   if (0 < changed)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "setServersDefaultDataFormat() failed ... returning NULL\n");
-      return NULL;
+      writeFormatCache(formatCacheFile);
    }
+}
 
-
-   /* check:
-    * 
-    * CLIENT/SERVER: identical format types
-    *  - if both, service and command, are set
-    *  	- check if format types of service and command are identical
-    * TODO:  - check also in case of string transport mode
-    */
-   if (false == checkConsistencyFormatTypes(thisRecord))
+void dimSetFormatCache(char *fileName)
+{
+   /* iocsh, before iocInit: use and maintain the format cache fileName */
+   if (NULL == fileName || 0 == strlen(fileName))
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "checkConsistencyFormatTypes() failed\n");
-      return NULL;
+      message(stderr,__FILE__,__LINE__,"ERROR","dimSetFormatCache", "usage: dimSetFormatCache <file name>\n");
+      return;
    }
-
-   /*
-    * determine needed datasize 
-    */
-   thisRecord->dataSize = determineDataSize(thisRecord);
-   if ( 0 == thisRecord->dataSize)
+   if (0 < recordIndex)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "determineDataSize() failed\n");
-      return NULL;
+      message(stderr,__FILE__,__LINE__,"ERROR","dimSetFormatCache", "has to be called before iocInit\n");
+      return;
    }
-
-   /*
-    *  type specific allocation 
-    * 
-    * (those relies upon previous check: check if service and command if formats are identical). s.a.
-    */
-
-   thisRecord->dimData = malloc( thisRecord->dataSize );
-   if ( NULL == thisRecord->dimData)
+   SAFE_FREE(formatCacheFile);
+   if (NULL == setHeapString(&formatCacheFile, fileName, "formatCacheFile", 0))
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "couldn't allocate memory for dimData ... returning NULL\n");
-      return NULL;
+      return;
+   }
+   if (false == readFormatCache(formatCacheFile))
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","dimSetFormatCache", "reading `%s' failed\n", formatCacheFile);
    }
+}
 
+bool preResolveInputOutput(char inputOutputField[], struct formatQuery **queries, int *numberOfQueries, void *pending)
+{
    /*
-    * record specific consistency checks:
+    * pre-scan of one INP/OUT string:
+    * client services and commands without format (@Sf/@Cf) 
+    * are added to the queries, unless known or already queued
     */
-
-   if (false == checkConsistencyRecordSpecific(thisRecord))
+   char   node[MAXIMUMDIMDNSADDRESSLENGTH+1] = {'\0'};
+   char   name[MAXIMUMDIMFORMATLENGTH]       = {'\0'};
+   char  *prefix = NULL;
+   char  *dnsAddress = NULL;            /* @D, node[:port] */
+   char  *names[2] = {NULL, NULL};      /* service, command */
+   bool   formats[2] = {false, false};
+   bool   client = false;
+   linkToken tokens[DIMMAXIMUMNUMBEROFKEYS];
+   /* copies of keys and arguments, never longer than the INP/OUT string itself */
+   char   strings[2*(strlen(inputOutputField)+1)];
+   char  *key      = NULL;
+   char  *argument = NULL;
+   size_t used = 0;
+   int    found_elements = 0;
+   int    i = 0, j = 0;
+
+   found_elements = tokenizeLink(inputOutputField, tokens, DIMMAXIMUMNUMBEROFKEYS,
+                                 DIM_PRIMARY_TOKEN[0], DIM_SECONDARY_TOKEN[0], DIM_THIRD_TOKEN[0], DIM_SPACE_TOKEN[0], DIM_TOKEN_PROTECTION );
+   if (0 > found_elements)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","createAndInitVariables", "checkConsistencyRecordSpecific() failed\n");
-      return NULL;
+      return false;
    }
 
-   /*
-    * set callback flag 
-    */
-   thisRecord->calledFromCallback = 0;
+   for (i = 0; i < found_elements; i++)
+   {
+      key       = &strings[used];
+      used     += 1 + copySlice(key, sizeof(strings)-used, tokens[i].key, DIM_SPACE_TOKEN[0], DIM_TOKEN_PROTECTION, DIMLINKTOKENS);
+      argument  = &strings[used];
+      used     += 1 + copySlice(argument, sizeof(strings)-used, tokens[i].argument, DIM_SPACE_TOKEN[0], DIM_TOKEN_PROTECTION, DIMLINKTOKENS);
 
-   /* *************************************************************************************************************** */
+      switch (toupper(key[0]))
+      {
+      case DIMTIERTYPE:
+         client = (DIMCLIENT == toupper(argument[0]));
+         break;
+      case DIMSERVERSNAMEPREFIX:
+         prefix = argument;
+         break;
+      case DIMDNSADDRESS:
+         dnsAddress = argument;
+         break;
+      case DIMSERVICE:
+      case DIMCOMMAND:
+         j = (DIMSERVICE == toupper(key[0])) ? 0 : 1;
+         if (!key[1])
+         {
+            names[j] = argument;
+         }
+         else if (DIMFORMAT == tolower(key[1]))
+         {
+            formats[j] = true;
+         }
+         break;
+      default:
+         break;
+      }
+   }
 
-   return thisRecord;
-}
+   /* DNS node, as in getFormat() */
+   dimDnsNodeKey(node, dnsAddress);
 
-bool retrieveAndSetClientServicesFormat(struct recordVariables *thisRecord)
-{
-   if (DIMCLIENT == thisRecord->dimTierType)
+   for (j = 0; j < 2 && true == client; j++)
    {
-      if ( thisRecord->dimServiceExists )
+      if (NULL == names[j] || 0 == strlen(names[j]) || true == formats[j])
       {
-         if (NULL == thisRecord->dimServiceFormat)
-         {
-            if (false == getServiceFormat(thisRecord->dimServiceFormat, thisRecord))
-            {
-               message(stderr,__FILE__,__LINE__,"ERROR","retrieveAndSetClientServicesFormat", "getServiceFormat() failed\n");
-               return false;
-            }
-
-            if (false == setRecordVariablesString(&(thisRecord->dimServiceFormat), thisRecord->dimServiceFormat, "dimServiceFormat", 0))
-            {
-               message(stderr,__FILE__,__LINE__,"ERROR","retrieveAndSetClientServicesFormat", "setRecordVariablesString failed\n");
-               return false;
-            }
-            if (false == disassembleFormat(thisRecord->dimServiceFormat,
-                                           &thisRecord->dimNumberOfServiceFormats,
-                                           &thisRecord->dimServiceDataTypes,
-                                           &thisRecord->dimNumberOfServiceDataTypesPerFormat))
-            {
-               message(stderr,__FILE__,__LINE__,"ERROR","retrieveAndSetClientServicesFormat", "disassembleFormat() failed");
-               return false;
-            }
-         }
+         continue;
       }
-      if ( thisRecord->dimCommandExists )
+      if (NULL != prefix)
       {
-         if (NULL == thisRecord->dimCommandFormat)
-         {
-            if (false == getCommandFormat(thisRecord->dimCommandFormat, thisRecord))
-            {
-               message(stderr,__FILE__,__LINE__,"ERROR","retrieveAndSetClientServicesFormat", "getCommandFormat() failed ... returning NULL\n");
-               return false;
-            }
+         snprintf(name, MAXIMUMDIMFORMATLENGTH, "%s%s%s", prefix, DIMSERVICESPREFIXSEPARATOR, names[j]);
+      }
+      else
+      {
+         snprintf(name, MAXIMUMDIMFORMATLENGTH, "%s", names[j]);
+      }
+      if (NULL != findFormatCacheEntry(name, node))
+      {
+         continue;
+      }
 
-            if (false == setRecordVariablesString(&(thisRecord->dimCommandFormat),
-                                                  thisRecord->dimCommandFormat, "dimCommandFormat", 0))
-            {
-               message(stderr,__FILE__,__LINE__,"ERROR","retrieveAndSetClientServicesFormat", "setRecordVariablesString failed\n");
-               return false;
-            }
-            if (false == disassembleFormat(thisRecord->dimCommandFormat,
-                                           &thisRecord->dimNumberOfCommandFormats,
-                                           &thisRecord->dimCommandDataTypes,
-                                           &thisRecord->dimNumberOfCommandDataTypesPerFormat))
+      /* queue once per name@node */
+      {
+         char key[MAXIMUMDIMFORMATLENGTH] = {'\0'};
+         struct formatQuery *query = NULL;
+
+         snprintf(key, MAXIMUMDIMFORMATLENGTH, "%s%s%s", name, DIMFORMATCACHEKEYSEPARATOR, node);
+         if (NULL != gphFind(pending, key, NULL))
+         {
+            continue;
+         }
+         if(0 == (*numberOfQueries)%MAX_DIMFormatCacheEntries)
+         {
+            *queries = (struct formatQuery*) realloc( *queries,
+                       sizeof(struct formatQuery) * ((*numberOfQueries) + MAX_DIMFormatCacheEntries));
+            if (NULL == *queries)
             {
-               message(stderr,__FILE__,__LINE__,"ERROR","retrieveAndSetClientServicesFormat", "disassembleFormat() failed");
+               message(stderr,__FILE__,__LINE__,"ERROR","preResolveInputOutput", "couldn't (re)allocate memory for format queries\n");
+               *numberOfQueries = 0;
                return false;
             }
          }
+         query = &(*queries)[(*numberOfQueries)++];
+         memset(query, 0, sizeof(struct formatQuery));
+         query->name = strdup(name);
+         query->node = strdup(node);
+         query->key  = strdup(key);
+         /* gphAdd does not copy the key */
+         gphAdd(pending, query->key, NULL);
       }
    }
+
    return true;
 }
 
-bool getServiceFormat(char *serviceFormat, struct recordVariables *thisRecord)
+int preResolveFormats(void)
 {
-   assert(NULL != thisRecord->dimServiceName);
-   int dummy[100];
-   /*   int dummy2 = -1000 ;*/
-   int id = dic_info_service(thisRecord->dimServiceName, ONCE_ONLY, 0, 0, 0, getDimFormatCallback, thisRecord->index, dummy, sizeof(int)*100);/*dim_call_back, -1, dummy, sizeof(dummy));*/
-   char *format = dic_get_format(id);
-   dic_release_service(id);
-   printf("format = %s\n",format);
+   /*
+    * before the records are initialised, init(after=0):
+    * collect all client services/commands without format of all DIM records,
+    * request their formats concurrently (one batch per DNS node)
+    * and put them into the format cache table, 
+    * retrieveAndSetClientServicesFormat() then finds them there,
+    * returns the number of records of this device type
+    */
+   DBENTRY dbentry;
+   long status = 0;
+   struct formatQuery *queries = NULL;
+   int numberOfQueries = 0;
+   void *pending = NULL;
+   char defaultNode[MAXIMUMDIMDNSADDRESSLENGTH+1] = {'\0'};
+   int i = 0, j = 0, first = 0;
+   int resolved = 0;
+   int numberOfRecords = 0;
+
+   if (NULL == pdbbase)
+   {
+      return 0;
+   }
+   gphInitPvt(&pending, 512);
 
-   if ( NULL == format )
+   dbInitEntry(pdbbase, &dbentry);
+   for (status = dbFirstRecordType(&dbentry); 0 == status; status = dbNextRecordType(&dbentry))
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","getServiceFormat", "empty format string ... returning NULL\n");
-      return false;
+      for (status = dbFirstRecord(&dbentry); 0 == status; status = dbNextRecord(&dbentry))
+      {
+         if (dbIsAlias(&dbentry))
+         {
+            continue;
+         }
+         if (0 != dbFindField(&dbentry, "DTYP") || 0 != strcmp(DIMDEVICETYPE, dbGetString(&dbentry)))
+         {
+            continue;
+         }
+         if (0 != dbFindField(&dbentry, "INP") && 0 != dbFindField(&dbentry, "OUT"))
+         {
+            continue;
+         }
+         numberOfRecords++;
+         if (false == preResolveInputOutput(dbGetString(&dbentry), &queries, &numberOfQueries, pending))
+         {
+            message(stderr,__FILE__,__LINE__,"WARNING","preResolveFormats", "pre-scan of record `%s' failed\n", dbGetRecordName(&dbentry));
+         }
+      }
    }
-   serviceFormat = (char*) malloc(sizeof(char) * (strlen(&format[0])+1));
-   if (NULL == serviceFormat)
+   dbFinishEntry(&dbentry);
+
+   /* concurrently, for each DNS node, the client's node is restored afterwards (if set at all) */
+   dic_get_dns_node(defaultNode);
+   for (first = 0; first < numberOfQueries; first = i)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","getServiceFormat", "couldn't allocate memory for format  ... returning NULL\n");
-      return false;
+      for (i = first; i < numberOfQueries && 0 == strcmp(queries[i].node, queries[first].node); i++)
+      {
+      }
+      /* same node not consecutive: bring them together */
+      for (j = i; j < numberOfQueries; j++)
+      {
+         if (0 == strcmp(queries[j].node, queries[first].node))
+         {
+            struct formatQuery swap = queries[i];
+            queries[i++] = queries[j];
+            queries[j] = swap;
+         }
+      }
+      if (0 < strlen(queries[first].node))
+      {
+         dic_set_dns_node(queries[first].node);
+      }
+      queryDimFormats(&queries[first], i - first);
    }
-   strncpy(serviceFormat, format, strlen(&format[0]));
-   return true;
+   if (0 < strlen(defaultNode))
+   {
+      dic_set_dns_node(defaultNode);
+   }
+   gphFreeMem(pending);
+
+   for (i = 0; i < numberOfQueries; i++)
+   {
+      if (NULL != queries[i].format)
+      {
+         addFormatCacheEntry(queries[i].name, queries[i].node, queries[i].format);
+         resolved++;
+      }
+      SAFE_FREE(queries[i].format);
+      SAFE_FREE(queries[i].name);
+      SAFE_FREE(queries[i].node);
+      SAFE_FREE(queries[i].key);
+   }
+   SAFE_FREE(queries);
+
+   if (0 < numberOfQueries)
+   {
+      message(stdout,NULL,0,"INFO","preResolveFormats", "formats of %i of %i service(s) resolved\n", resolved, numberOfQueries);
+   }
+   return numberOfRecords;
 }
 
-void getDimFormatCallback(long *tag,  void *data,  int *size)
+/* iocsh registration */
+static const iocshArg dimSetFormatCacheArg0 = {"file name", iocshArgString};
+static const iocshArg * const dimSetFormatCacheArgs[1] = {&dimSetFormatCacheArg0};
+static const iocshFuncDef dimSetFormatCacheFuncDef = {"dimSetFormatCache", 1, dimSetFormatCacheArgs};
+static void dimSetFormatCacheCallFunc(const iocshArgBuf *args)
 {
-   /*recordVariablesArray[tag]->*/
-   char *format = dic_get_format(0);
-   fprintf(stderr,"LINE %i: ",__LINE__);
-   printf("************ format = %s\n",format);
-
+   dimSetFormatCache(args[0].sval);
 }
 
-bool getCommandFormat(char *commandFormat, struct recordVariables *thisRecord)
+static const iocshArg dimDumpRecordArg0 = {"record name", iocshArgString};
+static const iocshArg * const dimDumpRecordArgs[1] = {&dimDumpRecordArg0};
+static const iocshFuncDef dimDumpRecordFuncDef = {"dimDumpRecord", 1, dimDumpRecordArgs};
+static void dimDumpRecordCallFunc(const iocshArgBuf *args)
 {
-   /* TODO: does this work ??? */
-   int dummy = -1000;
-   int id = dic_info_service(thisRecord->dimCommandName, MONITORED, 0, 0, 0, dimCallback, -1, dummy, sizeof(dummy));
-   char *format = dic_get_format(id);
-   dic_release_service(id);
+   dimDumpRecord(args[0].sval);
+}
 
-   printf("format = %s\n",format);
+static const iocshArg dimReportArg0 = {"interest level", iocshArgInt};
+static const iocshArg * const dimReportArgs[1] = {&dimReportArg0};
+static const iocshFuncDef dimReportFuncDef = {"dimReport", 1, dimReportArgs};
+static void dimReportCallFunc(const iocshArgBuf *args)
+{
+   dimReport(args[0].ival);
+}
 
-   if ( NULL == format )
+static const iocshArg dimMessageThresholdArg0 = {"severity 0:all 1:INFO 2:WARNING 3:ERROR", iocshArgInt};
+static const iocshArg * const dimMessageThresholdArgs[1] = {&dimMessageThresholdArg0};
+static const iocshFuncDef dimMessageThresholdFuncDef = {"dimMessageThreshold", 1, dimMessageThresholdArgs};
+static void dimMessageThresholdCallFunc(const iocshArgBuf *args)
+{
+   if (MESSAGE_DUMP > args[0].ival || MESSAGE_ERROR < args[0].ival)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","getCommandFormat", "empty format string ... returning NULL\n");
-      return false;
+      message(stderr,__FILE__,__LINE__,"ERROR","dimMessageThreshold", "usage: dimMessageThreshold <%i..%i>\n", MESSAGE_DUMP, MESSAGE_ERROR);
+      return;
    }
-   commandFormat = (char*) malloc(sizeof(char) * (strlen(&format[0])+1));
-   if (NULL ==  commandFormat)
+   setMessageThreshold(args[0].ival);
+}
+
+static const iocshArg dimMessageRateLimitArg0 = {"messages per second and call site, 0: unlimited", iocshArgInt};
+static const iocshArg * const dimMessageRateLimitArgs[1] = {&dimMessageRateLimitArg0};
+static const iocshFuncDef dimMessageRateLimitFuncDef = {"dimMessageRateLimit", 1, dimMessageRateLimitArgs};
+static void dimMessageRateLimitCallFunc(const iocshArgBuf *args)
+{
+   if (0 > args[0].ival)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR","getCommandFormat", "couldn't allocate memory for format  ... returning NULL\n");
-      return false;
+      message(stderr,__FILE__,__LINE__,"ERROR","dimMessageRateLimit", "usage: dimMessageRateLimit <messages per second, 0: unlimited>\n");
+      return;
    }
-   strncpy(commandFormat, format, strlen(&format[0]));
-   return true;
+   setMessageRateLimit((unsigned int) args[0].ival);
+}
+
+static void caDIMInterfaceRegistrar(void)
+{
+   iocshRegister(&dimSetFormatCacheFuncDef, dimSetFormatCacheCallFunc);
+   iocshRegister(&dimDumpRecordFuncDef, dimDumpRecordCallFunc);
+   iocshRegister(&dimReportFuncDef, dimReportCallFunc);
+   iocshRegister(&dimMessageThresholdFuncDef, dimMessageThresholdCallFunc);
+   iocshRegister(&dimMessageRateLimitFuncDef, dimMessageRateLimitCallFunc);
 }
+epicsExportRegistrar(caDIMInterfaceRegistrar);
 
 bool addServersPrefix(struct recordVariables *thisRecord)
 {
@@ -2152,85 +4211,33 @@ bool addServersPrefix(struct recordVariables *thisRecord)
     * if set, then add it in front of the service names in the form prefix/name, if name exists
     * (where the seperator '/' can be chosen by DIMSERVICESPREFIXSEPARATOR)
     */
-   if (NULL != thisRecord->dimServicesNamePrefix)
+   char **names[2] = {NULL, NULL};
+   int i = 0;
+
+   if (NULL == thisRecord->config->dimServicesNamePrefix)
    {
-      /* command */
-      if (NULL != thisRecord->dimCommandName)
+      return true;
+   }
+   names[0] = &thisRecord->config->dimCommandName;
+   names[1] = &thisRecord->config->dimServiceName;
+   for (i = 0; i < 2; i++)
+   {
+      char *name = *names[i];
+      size_t length = 0;
+
+      if (NULL == name)
       {
-         char* tmp = NULL;
-         thisRecord->dimCommandName = (char*) realloc(thisRecord->dimCommandName,
-                                      sizeof(char) * ( 1
-                                                       + strlen(thisRecord->dimCommandName)
-                                                       + strlen(DIMSERVICESPREFIXSEPARATOR)
-                                                       + strlen(thisRecord->dimServicesNamePrefix))
-                                                     );
-         if (NULL == thisRecord->dimCommandName)
-         {
-            message(stderr,__FILE__,__LINE__,"ERROR","addServersPrefix", "couldn't allocate memory for attaching prefix to service names  ... returning NULL\n");
-            return false;
-         }
-         tmp = (char*) calloc(( 1
-                                + strlen(thisRecord->dimCommandName)
-                                + strlen(DIMSERVICESPREFIXSEPARATOR)
-                                + strlen(thisRecord->dimServicesNamePrefix)),
-                              sizeof(char)
-                             );
-         if (NULL == tmp)
-         {
-            message(stderr,__FILE__,__LINE__,"ERROR","addServersPrefix", "couldn't allocate memory for attaching prefix to service names  ... returning NULL\n");
-            return false;
-         }
-         strncpy(tmp, thisRecord->dimServicesNamePrefix, strlen(thisRecord->dimServicesNamePrefix));
-         strncat(tmp, DIMSERVICESPREFIXSEPARATOR, strlen(DIMSERVICESPREFIXSEPARATOR));
-         strncat(tmp, thisRecord->dimCommandName, strlen(thisRecord->dimCommandName));
-
-         strncpy(thisRecord->dimCommandName,
-                 tmp,
-                 1
-                 + strlen(thisRecord->dimCommandName)
-                 + strlen(DIMSERVICESPREFIXSEPARATOR)
-                 + strlen(thisRecord->dimServicesNamePrefix)
-                );
-         SAFE_FREE(tmp);
-      }
-      /* service */
-      if (NULL != thisRecord->dimServiceName)
-      {
-         char* tmp = NULL;
-         thisRecord->dimServiceName = (char*) realloc(thisRecord->dimServiceName,
-                                      sizeof(char) * ( 1
-                                                       + strlen(thisRecord->dimServiceName)
-                                                       + strlen(DIMSERVICESPREFIXSEPARATOR)
-                                                       + strlen(thisRecord->dimServicesNamePrefix))
-                                                     );
-         if (NULL == thisRecord->dimServiceName)
-         {
-            message(stderr,__FILE__,__LINE__,"ERROR","addServersPrefix", "couldn't allocate memory for attaching prefix to service names  ... returning NULL\n");
-            return false;
-         }
-         tmp = (char*) calloc(( 1
-                                + strlen(thisRecord->dimServiceName)
-                                + strlen(DIMSERVICESPREFIXSEPARATOR)
-                                + strlen(thisRecord->dimServicesNamePrefix))
-                              ,sizeof(char)
-                             );
-         if (NULL == tmp)
-         {
-            message(stderr,__FILE__,__LINE__,"ERROR","addServersPrefix", "couldn't allocate memory for attaching prefix to service names  ... returning NULL\n");
-            return false;
-         }
-         strncpy(tmp, thisRecord->dimServicesNamePrefix, strlen(thisRecord->dimServicesNamePrefix));
-         strncat(tmp, DIMSERVICESPREFIXSEPARATOR, strlen(DIMSERVICESPREFIXSEPARATOR));
-         strncat(tmp, thisRecord->dimServiceName, strlen(thisRecord->dimServiceName));
-         strncpy(thisRecord->dimServiceName,
-                 tmp,
-                 1
-                 + strlen(thisRecord->dimServiceName)
-                 + strlen(DIMSERVICESPREFIXSEPARATOR)
-                 + strlen(thisRecord->dimServicesNamePrefix)
-                );
-         SAFE_FREE(tmp);
+         continue;
+      }
+      length = 1 + strlen(thisRecord->config->dimServicesNamePrefix) + strlen(DIMSERVICESPREFIXSEPARATOR) + strlen(name);
+      /* the old name stays in the arena */
+      *names[i] = recordAlloc(sizeof(char) * length);
+      if (NULL == *names[i])
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","addServersPrefix", "couldn't allocate memory for attaching prefix to service names  ... returning NULL\n");
+         return false;
       }
+      snprintf(*names[i], length, "%s%s%s", thisRecord->config->dimServicesNamePrefix, DIMSERVICESPREFIXSEPARATOR, name);
    }
    return true;
 }
@@ -2253,6 +4260,20 @@ bool setServersDefaultDataFormat(struct recordVariables *thisRecord)
       case DIMaoRecord:
          strncpy(datatype,DIMAIAODEFAULTDATATYPE,10000);
          break;
+      case DIMwaveformRecord:
+         {
+            /* type matching FTVL, NELM elements */
+            waveformRecord *pWaveformRecord = (waveformRecord*) thisRecord->recordAddress;
+            char dimDataType = ftvlDefaultDIMDataType(pWaveformRecord->ftvl);
+            if (0 == dimDataType)
+            {
+               message(stderr,__FILE__,__LINE__,"ERROR","setServersDefaultDataFormat", "FTVL %i of record `%s' not supported\n",
+                       pWaveformRecord->ftvl, pWaveformRecord->name);
+               return false;
+            }
+            snprintf(datatype, 10000, "%c%s%u", dimDataType, DIM_FIFTH_TOKEN, pWaveformRecord->nelm);
+         }
+         break;
       case DIMstringinRecord:
       case DIMstringoutRecord:
          strncpy(datatype,DIMSTRINGDEFAULTDATATYPE,10000);
@@ -2268,17 +4289,14 @@ bool setServersDefaultDataFormat(struct recordVariables *thisRecord)
 
       if ( thisRecord->dimCommandExists )
       {
-         if (NULL == thisRecord->dimCommandFormat)
+         if (NULL == thisRecord->config->dimCommandFormat)
          {
-            if (! setRecordVariablesString(&(thisRecord->dimCommandFormat), datatype, "dimCommandFormat", '\"'))
+            if (! setRecordVariablesInternedString(&(thisRecord->config->dimCommandFormat), datatype, "dimCommandFormat", '\"'))
             {
                message(stderr,__FILE__,__LINE__,"ERROR","setServersDefaultDataFormat", "setRecordVariablesString failed\n");
                return false;
             }
-            if (! disassembleFormat(thisRecord->dimCommandFormat,
-                                    &thisRecord->dimNumberOfCommandFormats,
-                                    &thisRecord->dimCommandDataTypes,
-                                    &thisRecord->dimNumberOfCommandDataTypesPerFormat))
+            if (! disassembleFormat(thisRecord->config->dimCommandFormat, &thisRecord->config->dimCommandFormatDescriptor))
             {
                message(stderr,__FILE__,__LINE__,"ERROR","setServersDefaultDataFormat", "disassembleFormat() failed");
                return false;
@@ -2287,17 +4305,14 @@ bool setServersDefaultDataFormat(struct recordVariables *thisRecord)
       }
       if ( thisRecord->dimServiceExists )
       {
-         if (NULL == thisRecord->dimServiceFormat)
+         if (NULL == thisRecord->config->dimServiceFormat)
          {
-            if (! setRecordVariablesString(&(thisRecord->dimServiceFormat), datatype, "dimServiceFormat", '\"'))
+            if (! setRecordVariablesInternedString(&(thisRecord->config->dimServiceFormat), datatype, "dimServiceFormat", '\"'))
             {
                message(stderr,__FILE__,__LINE__,"ERROR","setServersDefaultDataFormat", "setRecordVariablesString failed\n");
                return false;
             }
-            if (! disassembleFormat(thisRecord->dimServiceFormat,
-                                    &thisRecord->dimNumberOfServiceFormats,
-                                    &thisRecord->dimServiceDataTypes,
-                                    &thisRecord->dimNumberOfServiceDataTypesPerFormat))
+            if (! disassembleFormat(thisRecord->config->dimServiceFormat, &thisRecord->config->dimServiceFormatDescriptor))
             {
                message(stderr,__FILE__,__LINE__,"ERROR","setServersDefaultDataFormat", "disassembleFormat() failed");
                return false;
@@ -2319,70 +4334,66 @@ bool checkConsistencyFormatTypes(struct recordVariables *thisRecord)
    if (true == thisRecord->dimCommandExists && true == thisRecord->dimServiceExists)
    {
       /*string transport*/
-      if (true == thisRecord->stringTransportCommand || true == thisRecord->stringTransportService)
+      if (true == thisRecord->config->stringTransportCommand || true == thisRecord->config->stringTransportService)
       {
          /* both */
-         if (thisRecord->stringTransportCommand && thisRecord->stringTransportService)
+         if (thisRecord->config->stringTransportCommand && thisRecord->config->stringTransportService)
          {
-            if ( 0 != strncmp(thisRecord->dimStringTransportCommandFormat,
-                              thisRecord->dimStringTransportServiceFormat,
-                              strlen(thisRecord->dimServiceFormat)))
+            if ( false == equalFormatDescriptors(thisRecord->config->dimStringTransportCommandFormatDescriptor,
+                                                 thisRecord->config->dimStringTransportServiceFormatDescriptor))
             {
                message(stderr,__FILE__,__LINE__,"ERROR","checkConsistencyFormatTypes",
                        "data formats of command `%s': `%s' (string transport) and service `%s': `%s' (string transport) are not the same\n",
-                       thisRecord->dimCommandName,
-                       thisRecord->dimStringTransportCommandFormat,
-                       thisRecord->dimServiceName,
-                       thisRecord->dimStringTransportServiceFormat);
+                       thisRecord->config->dimCommandName,
+                       thisRecord->config->dimStringTransportCommandFormat,
+                       thisRecord->config->dimServiceName,
+                       thisRecord->config->dimStringTransportServiceFormat);
                return false;
             }
          }
          /* command only */
-         else if (true == thisRecord->stringTransportCommand && false == thisRecord->stringTransportService)
+         else if (true == thisRecord->config->stringTransportCommand && false == thisRecord->config->stringTransportService)
          {
-            if ( 0 != strncmp(thisRecord->dimStringTransportCommandFormat,
-                              thisRecord->dimServiceFormat,
-                              strlen(thisRecord->dimServiceFormat)))
+            if ( false == equalFormatDescriptors(thisRecord->config->dimStringTransportCommandFormatDescriptor,
+                                                 thisRecord->config->dimServiceFormatDescriptor))
             {
                message(stderr,__FILE__,__LINE__,"ERROR","checkConsistencyFormatTypes",
                        "data formats of command `%s': `%s' (string transport) and service `%s': `%s' are not the same\n",
-                       thisRecord->dimCommandName,
-                       thisRecord->dimStringTransportCommandFormat,
-                       thisRecord->dimServiceName,
-                       thisRecord->dimServiceFormat);
+                       thisRecord->config->dimCommandName,
+                       thisRecord->config->dimStringTransportCommandFormat,
+                       thisRecord->config->dimServiceName,
+                       thisRecord->config->dimServiceFormat);
                return false;
             }
          }
 
          /* service only */
-         else /*(false == thisRecord->stringTransportCommand && true == thisRecord->stringTransportService)*/
+         else /*(false == thisRecord->config->stringTransportCommand && true == thisRecord->config->stringTransportService)*/
          {
-            if ( 0 != strncmp(thisRecord->dimCommandFormat,
-                              thisRecord->dimStringTransportServiceFormat,
-                              strlen(thisRecord->dimServiceFormat)))
+            if ( false == equalFormatDescriptors(thisRecord->config->dimCommandFormatDescriptor,
+                                                 thisRecord->config->dimStringTransportServiceFormatDescriptor))
             {
                message(stderr,__FILE__,__LINE__,"ERROR","checkConsistencyFormatTypes",
                        "data formats of command `%s': `%s' and service `%s': `%s' (string transport) are not the same\n",
-                       thisRecord->dimCommandName,
-                       thisRecord->dimCommandFormat,
-                       thisRecord->dimServiceName,
-                       thisRecord->dimStringTransportServiceFormat);
+                       thisRecord->config->dimCommandName,
+                       thisRecord->config->dimCommandFormat,
+                       thisRecord->config->dimServiceName,
+                       thisRecord->config->dimStringTransportServiceFormat);
                return false;
             }
          }
       }
-      else /*(false == thisRecord->stringTransportCommand || false == thisRecord->stringTransportService)*/
+      else /*(false == thisRecord->config->stringTransportCommand || false == thisRecord->config->stringTransportService)*/
       {
-         if ( 0 != strncmp(thisRecord->dimCommandFormat,
-                           thisRecord->dimServiceFormat,
-                           strlen(thisRecord->dimServiceFormat)))
+         if ( false == equalFormatDescriptors(thisRecord->config->dimCommandFormatDescriptor,
+                                              thisRecord->config->dimServiceFormatDescriptor))
          {
             message(stderr,__FILE__,__LINE__,"ERROR", "checkConsistencyFormatTypes",
                     "data formats of command `%s': `%s' and service `%s': `%s' are not the same\n",
-                    thisRecord->dimCommandName,
-                    thisRecord->dimCommandFormat,
-                    thisRecord->dimServiceName,
-                    thisRecord->dimServiceFormat);
+                    thisRecord->config->dimCommandName,
+                    thisRecord->config->dimCommandFormat,
+                    thisRecord->config->dimServiceName,
+                    thisRecord->config->dimServiceFormat);
             return false;
          }
       }
@@ -2405,43 +4416,97 @@ bool checkConsistencyRecordSpecific(struct recordVariables *thisRecord)
          /* command */
          if (true == thisRecord->dimCommandExists)
          {
-            if (1 != thisRecord->dimNumberOfCommandFormats)
+            if (1 != thisRecord->config->dimCommandFormatDescriptor->numberOfElements)
+            {
+               message(stderr,__FILE__,__LINE__,"ERROR",
+                       "checkConsistencyRecordSpecific", "structures not supported by `%sRecord', like '%s`",
+                       thisRecord->config->recordType, thisRecord->config->dimCommandFormat);
+               return false;
+            }
+            assert(1 == thisRecord->config->dimCommandFormatDescriptor->numberOfElements);
+            if ( false == thisRecord->config->stringTransportCommand )
+            {
+               if (1 != thisRecord->config->dimCommandFormatDescriptor->elements[0].count )
+               {
+                  message(stderr,__FILE__,__LINE__,"ERROR",
+                          "checkConsistencyRecordSpecific", "arrays not supported, by `%sRecord', like '%s`",
+                          thisRecord->config->recordType, thisRecord->config->dimCommandFormat);
+                  return false;
+               }
+            }
+         }
+         /* service */
+         if (true == thisRecord->dimServiceExists)
+         {
+            if (1 != thisRecord->config->dimServiceFormatDescriptor->numberOfElements)
+            {
+               message(stderr,__FILE__,__LINE__,"ERROR",
+                       "checkConsistencyRecordSpecific", "structures not supported by `%sRecord', like '%s`\n",
+                       thisRecord->config->recordType, thisRecord->config->dimServiceFormat);
+               return false;
+            }
+            assert(1 == thisRecord->config->dimServiceFormatDescriptor->numberOfElements);
+            if ( false == thisRecord->config->stringTransportService )
+            {
+               if (1 != thisRecord->config->dimServiceFormatDescriptor->elements[0].count)
+               {
+                  message(stderr,__FILE__,__LINE__,"ERROR",
+                          "checkConsistencyRecordSpecific", "arrays not supported, by `%sRecord', like '%s`\n",
+                          thisRecord->config->recordType, thisRecord->config->dimServiceFormat);
+                  return false;
+               }
+            }
+         }
+         if (true == thisRecord->zeroCopy)
+         {
+            message(stderr,__FILE__,__LINE__,"ERROR",
+                    "checkConsistencyRecordSpecific", "zero copy (%s%c%c) not supported by `%sRecord'\n",
+                    DIM_PRIMARY_TOKEN, DIMEXTENSIONS, DIMEXTENSIONSZEROCOPY, thisRecord->config->recordType);
+            return false;
+         }
+         break;
+      case DIMwaveformRecord:
+         {
+            /* arrays of one type, no structures */
+            if (true == thisRecord->dimCommandExists && 1 != thisRecord->config->dimCommandFormatDescriptor->numberOfElements)
             {
                message(stderr,__FILE__,__LINE__,"ERROR",
-                       "checkConsistencyRecordSpecific", "structures not supported by `%sRecord', like '%s`",
-                       thisRecord->recordType, thisRecord->dimCommandFormat);
+                       "checkConsistencyRecordSpecific", "structures not supported by `%sRecord', like '%s`\n",
+                       thisRecord->config->recordType, thisRecord->config->dimCommandFormat);
                return false;
             }
-            assert(1 == thisRecord->dimNumberOfCommandFormats);
-            if ( false == thisRecord->stringTransportCommand )
+            if (true == thisRecord->dimServiceExists && 1 != thisRecord->config->dimServiceFormatDescriptor->numberOfElements)
             {
-               if (1 != thisRecord->dimNumberOfCommandDataTypesPerFormat[0] )
-               {
-                  message(stderr,__FILE__,__LINE__,"ERROR",
-                          "checkConsistencyRecordSpecific", "arrays not supported, by `%sRecord', like '%s`",
-                          thisRecord->recordType, thisRecord->dimCommandFormat);
-                  return false;
-               }
+               message(stderr,__FILE__,__LINE__,"ERROR",
+                       "checkConsistencyRecordSpecific", "structures not supported by `%sRecord', like '%s`\n",
+                       thisRecord->config->recordType, thisRecord->config->dimServiceFormat);
+               return false;
             }
-         }
-         /* service */
-         if (true == thisRecord->dimServiceExists)
-         {
-            if (1 != thisRecord->dimNumberOfServiceFormats)
+            if (true == thisRecord->config->stringTransportCommand || true == thisRecord->config->stringTransportService)
             {
                message(stderr,__FILE__,__LINE__,"ERROR",
-                       "checkConsistencyRecordSpecific", "structures not supported by `%sRecord', like '%s`\n",
-                       thisRecord->recordType, thisRecord->dimServiceFormat);
+                       "checkConsistencyRecordSpecific", "string transport not supported by `%sRecord'\n",
+                       thisRecord->config->recordType);
                return false;
             }
-            assert(1 == thisRecord->dimNumberOfServiceFormats);
-            if ( false == thisRecord->stringTransportService )
+            /* zero copy: served service with the FTVL's DIM type */
+            if (true == thisRecord->zeroCopy)
             {
-               if (1 != thisRecord->dimNumberOfServiceDataTypesPerFormat[0])
+               waveformRecord *pWaveformRecord = (waveformRecord*) thisRecord->recordAddress;
+
+               if (DIMSERVER != thisRecord->dimTierType || false == thisRecord->dimServiceExists)
                {
                   message(stderr,__FILE__,__LINE__,"ERROR",
-                          "checkConsistencyRecordSpecific", "arrays not supported, by `%sRecord', like '%s`\n",
-                          thisRecord->recordType, thisRecord->dimServiceFormat);
+                          "checkConsistencyRecordSpecific", "zero copy (%s%c%c) only for services of a server\n",
+                          DIM_PRIMARY_TOKEN, DIMEXTENSIONS, DIMEXTENSIONSZEROCOPY);
+                  return false;
+               }
+               if (ftvlDefaultDIMDataType(pWaveformRecord->ftvl) != thisRecord->config->dimServiceFormatDescriptor->elements[0].type)
+               {
+                  message(stderr,__FILE__,__LINE__,"ERROR",
+                          "checkConsistencyRecordSpecific", "zero copy (%s%c%c): DIM data type '%c` does not match FTVL %i of record `%s'\n",
+                          DIM_PRIMARY_TOKEN, DIMEXTENSIONS, DIMEXTENSIONSZEROCOPY,
+                          thisRecord->config->dimServiceFormatDescriptor->elements[0].type, pWaveformRecord->ftvl, pWaveformRecord->name);
                   return false;
                }
             }
@@ -2460,6 +4525,37 @@ bool checkConsistencyRecordSpecific(struct recordVariables *thisRecord)
    return true;
 }
 
+bool setArrayDefaultNumberOfElements(struct recordVariables *thisRecord)
+{
+   /*
+    * arrays without given number of elements (0),
+    * waveform: NELM elements, data received is clipped to NELM
+    */
+   unsigned int numberOfElements = 0;
+
+   switch(thisRecord->recordTypeIndex)
+   {
+   case DIMwaveformRecord:
+      numberOfElements = ((waveformRecord*) thisRecord->recordAddress)->nelm;
+      break;
+   default:
+      return true;
+   }
+
+   /* descriptors are shared: use the one of "<type>:<numberOfElements>" */
+   if (true == thisRecord->dimCommandExists
+       && false == setFormatDescriptorNumberOfElements(&thisRecord->config->dimCommandFormatDescriptor, numberOfElements))
+   {
+      return false;
+   }
+   if (true == thisRecord->dimServiceExists
+       && false == setFormatDescriptorNumberOfElements(&thisRecord->config->dimServiceFormatDescriptor, numberOfElements))
+   {
+      return false;
+   }
+   return true;
+}
+
 unsigned int determineDataSize(struct recordVariables *thisRecord)
 {
    unsigned int dataSize = 0;
@@ -2472,36 +4568,28 @@ unsigned int determineDataSize(struct recordVariables *thisRecord)
 
 
    /* string transport active */
-   if (true == thisRecord->stringTransportCommand || true == thisRecord->stringTransportService)
+   if (true == thisRecord->config->stringTransportCommand || true == thisRecord->config->stringTransportService)
    {
-      if (true == thisRecord->stringTransportCommand) /* also includes case both, where consistency has been checked previously */
+      if (true == thisRecord->config->stringTransportCommand) /* also includes case both, where consistency has been checked previously */
       {
-         dataSize = calculateDataSize(thisRecord->dimStringTransportNumberOfCommandFormats,
-                                      thisRecord->dimStringTransportCommandDataTypes,
-                                      thisRecord->dimStringTransportNumberOfCommandDataTypesPerFormat);
+         dataSize = formatDataSize(thisRecord->config->dimStringTransportCommandFormatDescriptor);
 
       }
-      else if(true == thisRecord->stringTransportService)
+      else if(true == thisRecord->config->stringTransportService)
       {
-         dataSize = calculateDataSize(thisRecord->dimStringTransportNumberOfServiceFormats,
-                                      thisRecord->dimStringTransportServiceDataTypes,
-                                      thisRecord->dimStringTransportNumberOfServiceDataTypesPerFormat);
+         dataSize = formatDataSize(thisRecord->config->dimStringTransportServiceFormatDescriptor);
       }
    }
    else /* normal transport */
    {
       if (true == thisRecord->dimCommandExists) /* also includes case both, where consistency has been checked previously */
       {
-         dataSize = calculateDataSize(thisRecord->dimNumberOfCommandFormats,
-                                      thisRecord->dimCommandDataTypes,
-                                      thisRecord->dimNumberOfCommandDataTypesPerFormat);
+         dataSize = formatDataSize(thisRecord->config->dimCommandFormatDescriptor);
 
       }
       else if (true == thisRecord->dimServiceExists)
       {
-         dataSize = calculateDataSize(thisRecord->dimNumberOfServiceFormats,
-                                      thisRecord->dimServiceDataTypes,
-                                      thisRecord->dimNumberOfServiceDataTypesPerFormat);
+         dataSize = formatDataSize(thisRecord->config->dimServiceFormatDescriptor);
       }
    }
 
@@ -2517,77 +4605,166 @@ unsigned int determineDataSize(struct recordVariables *thisRecord)
    }
 }
 
-unsigned int calculateDataSize(unsigned int numberOfFormats,
-                               char dataTypes[],
-                               unsigned int numberOfDataTypesPerFormat[])
+void* recordAlloc(size_t size)
 {
-   unsigned int dataSize = 0;
-   int format=0;
-   int number=0;
-   char dimDataType = 0;
+   /*
+    * memory for the configuration of a record (strings, format arrays),
+    * taken from recordArena, never freed separately,
+    * all of it is released at once by releaseRecordArena() at exit
+    */
+   if (NULL == recordArena.first && false == initRecordArena(0))
+   {
+      return NULL;
+   }
+   return arenaAlloc(&recordArena, size);
+}
+
+bool initRecordArena(int numberOfRecords)
+{
+   /* one arena for the IOC's lifetime, its blocks sized for all records found */
+   size_t blockSize = DIMARENABYTESPERRECORD * (size_t) numberOfRecords;
 
-   if (0 == numberOfFormats)
+   if (NULL != recordArena.first)
+   {
+      return true;
+   }
+   if (DIMARENAMINIMUMBLOCKSIZE > blockSize)
+   {
+      blockSize = DIMARENAMINIMUMBLOCKSIZE;
+   }
+   if (false == initArena(&recordArena, blockSize))
    {
+      message(stderr,__FILE__,__LINE__,"ERROR","initRecordArena", "couldn't allocate memory for the records' configuration\n");
+      return false;
+   }
+   epicsAtExit(releaseRecordArena, NULL);
+   return true;
+}
 
-      message(stderr,__FILE__,__LINE__,"ERROR",
-              "calculateDataSize", "number of formats == 0!\n");
-      return 0;
+bool initRecordPool(int numberOfRecords)
+{
+   /*
+    * the recordVariables used by process() and the DIM callbacks
+    * are taken from one contiguous array, one for each record found by the pre-scan,
+    * the structs are never moved or freed (DIM tags point to them)
+    */
+   if (NULL != recordPool || 0 >= numberOfRecords)
+   {
+      return true;
    }
-   if (NULL == dataTypes)
+   recordPool = (struct recordVariables*) calloc(numberOfRecords, sizeof(struct recordVariables));
+   if (NULL == recordPool)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR",
-              "calculateDataSize", "array of dataTypes empty!\n");
-      return 0;
+      message(stderr,__FILE__,__LINE__,"ERROR","initRecordPool", "couldn't allocate memory for %i records\n", numberOfRecords);
+      return false;
    }
-   if (NULL == numberOfDataTypesPerFormat)
+   recordPoolSize = numberOfRecords;
+   recordPoolUsed = 0;
+   return true;
+}
+
+struct recordVariables* recordPoolAlloc(void)
+{
+   /* next struct of the pool, a separate one if the pool is used up (records not seen by the pre-scan) */
+   if (recordPoolUsed < recordPoolSize)
    {
-      message(stderr,__FILE__,__LINE__,"ERROR",
-              "calculateDataSize", "array of number of dataTypes per format empty!\n");
-      return 0;
+      return &recordPool[recordPoolUsed++];
+   }
+   return (struct recordVariables*) calloc(1, sizeof(struct recordVariables));
+}
+
+void releaseMessageLogger(void *arg)
+{
+   /* messages still queued are printed before the IOC exits */
+   stopMessageLogger();
+}
+
+void releaseRecordArena(void *arg)
+{
+   if (NULL != internTable)
+   {
+      gphFreeMem(internTable);
+      internTable = NULL;
+   }
+   clearArena(&recordArena);
+}
+
+char* internString(char string[])
+{
+   /*
+    * returns the one copy of string held in the intern table,
+    * identical strings share that copy and can be compared by pointer,
+    * it must never be changed
+    */
+   GPHENTRY *hashEntry = NULL;
+   char *copy = NULL;
+
+   if (NULL == string)
+   {
+      return NULL;
+   }
+   if (NULL == internTable)
+   {
+      gphInitPvt(&internTable, 512);
+   }
+   internedReferences++;
+   hashEntry = gphFind(internTable, string, NULL);
+   if (NULL != hashEntry)
+   {
+      internedBytesSaved += strlen(string) + 1;
+      return (char*) hashEntry->userPvt;
    }
-   for (format =0; format < numberOfFormats; format++)
+   copy = recordAlloc(sizeof(char)*(1+strlen(string)));
+   if (NULL == copy)
    {
-      dimDataType = dataTypes[format];
-      for (number =0; number < numberOfDataTypesPerFormat[number]; number++)
+      return NULL;
+   }
+   strcpy(copy, string);
+   /* gphAdd does not copy the key */
+   hashEntry = gphAdd(internTable, copy, NULL);
+   if (NULL == hashEntry)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","internString", "couldn't add `%s' to intern table\n", string);
+      return NULL;
+   }
+   hashEntry->userPvt = copy;
+   internedStrings++;
+   return copy;
+}
+
+char* setRecordVariablesInternedString(char **element, char argument[], char discription[], char key)
+{
+   /* as setRecordVariablesString(), but *element is shared with other records, s. internString() */
+   if (argument && strlen(argument))
+   {
+      *element = internString(argument);
+      if( !*element)
       {
-         switch(dimDataType)
-         {
-         case 'I':
-            dataSize += sizeof(int);
-            break;
-         case 'D':
-            dataSize += sizeof(double);
-            break;
-         case 'S':
-            dataSize += sizeof(short);
-            break;
-         case 'C':
-            dataSize += sizeof(char);
-            break;
-         case 'L':
-            dataSize += sizeof(long);
-            break;
-         case 'X':
-            dataSize += sizeof(longlong);
-            break;
-         default:
-            {
-               message(stderr,__FILE__,__LINE__,"ERROR",
-                       "calculateDataSize", "DIM data type '%c` not (yet) supported",dimDataType);
-               return 0;
-            }
-            break;
-         }
+         message(stderr,__FILE__,__LINE__,"ERROR","setRecordVariablesInternedString", "couldn't allocate memory for %s string\n",discription);
+         return NULL;
+      }
+   }
+   else
+   {
+      if (0 != key)
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","setRecordVariablesInternedString","argument of key `%s%c' is empty\n",DIM_PRIMARY_TOKEN,key);
+      }
+      else
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","setRecordVariablesInternedString","argument is empty\n");
       }
+      return NULL;
    }
-   return dataSize;
+   return *element;
 }
 
 char* setRecordVariablesString(char **element, char argument[], char discription[], char key)
 {
+   /* copy of argument, allocated by recordAlloc() */
    if (argument && strlen(argument))
    {
-      *element = malloc(sizeof(char)*(1+strlen(argument)));
+      *element = recordAlloc(sizeof(char)*(1+strlen(argument)));
       if( !*element)
       {
          message(stderr,__FILE__,__LINE__,"ERROR","setRecordVariablesString", "couldn't allocate memory for %s string\n",discription);
@@ -2610,6 +4787,34 @@ char* setRecordVariablesString(char **element, char argument[], char discription
    return *element;
 }
 
+char* setHeapString(char **element, char argument[], char discription[], char key)
+{
+   /* copy of argument, allocated on the heap, to be freed by the caller */
+   if (argument && strlen(argument))
+   {
+      *element = malloc(sizeof(char)*(1+strlen(argument)));
+      if( !*element)
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","setHeapString", "couldn't allocate memory for %s string\n",discription);
+         return NULL;
+      }
+      strncpy (&((*element)[0]), argument, 1+strlen(argument) );
+   }
+   else
+   {
+      if (0 != key)
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","setHeapString","argument of key `%s%c' is empty\n",DIM_PRIMARY_TOKEN,key);
+      }
+      else
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","setHeapString","argument is empty\n");
+      }
+      return NULL;
+   }
+   return *element;
+}
+
 bool checkValidType(char *type)
 {
    bool isValid=false;
@@ -2640,65 +4845,224 @@ bool checkValidType(char *type)
    return isValid;
 }
 
-bool disassembleFormat(char formatString[],
-                       unsigned int* dimNumberOfCommandFormats,
-                       char** dimCommandDataTypes,
-                       unsigned int** dimNumberOfCommandDataTypesPerFormat )
+unsigned int dimDataTypeSize(char dimDataType)
+{
+   /* bytes of one element of a DIM data type, as used by the conversion kernels */
+   switch(toupper(dimDataType))
+   {
+   case 'I':
+      return sizeof(int);
+   case 'D':
+      return sizeof(double);
+   case 'F':
+      return sizeof(float);
+   case 'S':
+      return sizeof(short);
+   case 'C':
+      return sizeof(char);
+   case 'L':
+      return sizeof(epicsInt32);
+   case 'X':
+      return sizeof(longlong);
+   default:
+      message(stderr,__FILE__,__LINE__,"ERROR",
+              "dimDataTypeSize", "DIM data type '%c` not (yet) supported",dimDataType);
+      return 0;
+   }
+}
+
+struct dimFormatDescriptor* compileFormat(char formatString[])
 {
-   int     dimFormatIndex = 0, dimTypeIndex=0;
-   int     foundFormatArguments=0;
-   int     value=0;
-   char  **typeArray    =NULL;
-   int    *numberArray  =NULL;
+   /*
+    * compiles a DIM format string, e.g. "I:2;D:4;C", into a descriptor:
+    * per element type, count, byte offset (natural alignment, as a C struct) and size,
+    * a missing count (only allowed for the last element) means a variable number (0),
+    * the total size is padded to the largest alignment,
+    *
+    * descriptors are built once per format string and shared,
+    * they live in recordArena and must not be changed
+    */
+   static void *formatDescriptorTable = NULL;
+   struct dimFormatDescriptor *descriptor = NULL;
+   GPHENTRY *hashEntry = NULL;
+   char **typeArray    = NULL;
+   int   *numberArray  = NULL;
+   int    numberOfElements = 0;
+   int    i = 0;
+   unsigned int offset = 0;
+   unsigned int alignment = 1;
+   char  *key = NULL;
+
+   if (NULL == formatString || 0 == strlen(formatString))
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","compileFormat", "empty format string\n");
+      return NULL;
+   }
+   if (NULL == formatDescriptorTable)
+   {
+      gphInitPvt(&formatDescriptorTable, 256);
+   }
+   hashEntry = gphFind(formatDescriptorTable, formatString, NULL);
+   if (NULL != hashEntry)
+   {
+      return (struct dimFormatDescriptor*) hashEntry->userPvt;
+   }
 
-   *dimNumberOfCommandFormats = disassembleDIMFormatString(formatString,&typeArray,&numberArray, DIM_FOURTH_TOKEN, DIM_FIFTH_TOKEN, DIM_TOKEN_PROTECTION);
+   numberOfElements = disassembleDIMFormatString(formatString,&typeArray,&numberArray, DIM_FOURTH_TOKEN, DIM_FIFTH_TOKEN, DIM_TOKEN_PROTECTION);
+   if (0 >= numberOfElements)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","compileFormat", "could not disassemble format `%s'\n", formatString);
+      return NULL;
+   }
 
-   if(*dimNumberOfCommandFormats >0)
+   descriptor = (struct dimFormatDescriptor*) recordAlloc(sizeof(struct dimFormatDescriptor)
+                                                          + numberOfElements * sizeof(struct dimFormatElement));
+   if (NULL == descriptor)
    {
-      /*
-       * TODO: extend to structs
-       * status: do not allow more than one type
-       *         and skip if not 
-       */
+      message(stderr,__FILE__,__LINE__,"ERROR","compileFormat", "couldn't allocate memory for descriptor of `%s'\n", formatString);
+   }
+
+   for (i = 0; i < numberOfElements && NULL != descriptor; i++)
+   {
+      struct dimFormatElement *element = &descriptor->elements[i];
 
-      if(*dimNumberOfCommandFormats >1)
+      /* check for valid data type */
+      if (NULL == typeArray[i] || !checkValidType(typeArray[i]))
       {
-         message(stderr,__FILE__,__LINE__,"ERROR","disassembleFormat", "cannot support structures (up to NOW),%s`%s'%s\n",
-                 "i.e. only one element type is allowed, but not",formatString,"  ... returning false");
-         return false;
+         message(stderr,__FILE__,__LINE__,"ERROR","compileFormat", "checkValidType() failed");
+         descriptor = NULL;
+         break;
+      }
+      if (0 > numberArray[i])
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","compileFormat",
+                 "negative number of items (%i) in `%s'\n", numberArray[i], formatString);
+         descriptor = NULL;
+         break;
+      }
+      if (0 == numberArray[i] && i != numberOfElements-1)
+      {
+         message(stderr,__FILE__,__LINE__,"ERROR","compileFormat",
+                 "only the last element of `%s' may have a variable number of items\n", formatString);
+         descriptor = NULL;
+         break;
+      }
+      element->type = toupper(typeArray[i][0]);
+      element->count = numberArray[i];
+      element->size = dimDataTypeSize(element->type);
+      if (0 == element->size)
+      {
+         descriptor = NULL;
+         break;
       }
 
-      *dimCommandDataTypes = malloc(sizeof(char)*((*dimNumberOfCommandFormats)+1));
-      *dimNumberOfCommandDataTypesPerFormat = malloc(sizeof(char)*((*dimNumberOfCommandFormats)+1));
+      /* natural alignment */
+      offset = (offset + element->size - 1) / element->size * element->size;
+      element->offset = offset;
+      offset += element->size * element->count;
+      if (element->size > alignment)
+      {
+         alignment = element->size;
+      }
+   }
 
-      for (dimFormatIndex = 0; dimFormatIndex < *dimNumberOfCommandFormats; dimFormatIndex++)
+   for (i = 0; i < numberOfElements; i++)
+   {
+      if (NULL != typeArray[i])
       {
-         /* check for valid data type */
-         if (!checkValidType(typeArray[dimFormatIndex]))
-         {
-            message(stderr,__FILE__,__LINE__,"ERROR","disassembleFormat", "checkValidType() failed");
-            return false;
-         }
-         value=toupper(typeArray[dimFormatIndex][0]);
+         safeStringFree(&typeArray[i],strlen(typeArray[i]));
+      }
+   }
+   safePArrayFree((void**)typeArray,numberOfElements);
+   SAFE_FREE(numberArray);
 
-         for (dimTypeIndex=0; dimTypeIndex<DIMDataTypeLastDummyEntry; dimTypeIndex++)
-         {
-            if ( DIMInterfaceSupportedDIMDataTypesNames[dimTypeIndex] == value)
-            {
-               (*dimCommandDataTypes)[dimFormatIndex] = DIMInterfaceSupportedDIMDataTypesNames[dimTypeIndex];
-               (*dimNumberOfCommandDataTypesPerFormat)[dimFormatIndex] = numberArray[dimFormatIndex];
-               break;
-            }
-         }
+   if (NULL == descriptor)
+   {
+      return NULL;
+   }
+   descriptor->numberOfElements = numberOfElements;
+   descriptor->alignment = alignment;
+   descriptor->size = (offset + alignment - 1) / alignment * alignment;
+   descriptor->variableLength = (0 == descriptor->elements[numberOfElements-1].count);
+
+   /* gphAdd does not copy the key */
+   key = internString(formatString);
+   if (NULL != key && NULL != (hashEntry = gphAdd(formatDescriptorTable, key, NULL)))
+   {
+      hashEntry->userPvt = descriptor;
+   }
+   return descriptor;
+}
+
+bool disassembleFormat(char formatString[], struct dimFormatDescriptor **descriptor)
+{
+   *descriptor = compileFormat(formatString);
+   return (NULL != *descriptor);
+}
+
+unsigned int formatDataSize(struct dimFormatDescriptor *descriptor)
+{
+   if (NULL == descriptor)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","formatDataSize", "no format descriptor\n");
+      return 0;
+   }
+   return descriptor->size;
+}
+
+bool equalFormatDescriptors(struct dimFormatDescriptor *first, struct dimFormatDescriptor *second)
+{
+   /* same layout, the strings of the formats may differ (e.g. "d:1" and "D:1") */
+   if (first == second)
+   {
+      return true;
+   }
+   if (NULL == first || NULL == second || first->numberOfElements != second->numberOfElements)
+   {
+      return false;
+   }
+   return (0 == memcmp(first->elements, second->elements, first->numberOfElements * sizeof(struct dimFormatElement)));
+}
+
+bool setFormatDescriptorNumberOfElements(struct dimFormatDescriptor **descriptor, unsigned int numberOfElements)
+{
+   /* single type format with a variable number of items: replace by the descriptor of "<type>:<numberOfElements>" */
+   char format[32] = {'\0'};
+
+   if (NULL == *descriptor || 1 != (*descriptor)->numberOfElements || 0 != (*descriptor)->elements[0].count)
+   {
+      return true;
+   }
+   snprintf(format, sizeof(format), "%c%s%u", (*descriptor)->elements[0].type, DIM_FIFTH_TOKEN, numberOfElements);
+   *descriptor = compileFormat(format);
+   return (NULL != *descriptor);
+}
+
+void dumpFormatDescriptor(FILE *stream, char title[], struct dimFormatDescriptor *descriptor)
+{
+   unsigned int i = 0;
 
-         safeStringFree(&typeArray[dimFormatIndex],strlen(typeArray[dimFormatIndex]));
+   message(stream, NULL, 0, "DUMP", NULL, "%s", title);
+   if (NULL == descriptor)
+   {
+      message(stream, NULL, 0, "DUMP", NULL, "\t\t%p\n", descriptor);
+      return;
+   }
+   for (i = 0; i < descriptor->numberOfElements; i++)
+   {
+      if (0 == descriptor->elements[i].count)
+      {
+         message(stream, NULL, 0, "DUMP", NULL, "\t\t'%c' x 0 (=any) @ %u\n",
+                 descriptor->elements[i].type, descriptor->elements[i].offset);
+      }
+      else
+      {
+         message(stream, NULL, 0, "DUMP", NULL, "\t\t'%c' x %u @ %u\n",
+                 descriptor->elements[i].type, descriptor->elements[i].count, descriptor->elements[i].offset);
       }
    }
-   safePArrayFree((void**)typeArray,foundFormatArguments);
-   SAFE_FREE(numberArray);
-   /* fprintf(stdout,"\n");
-    * fflush(stdout);*/
-   return true;
+   message(stream, NULL, 0, "DUMP", NULL, "\t\tsize %u, alignment %u%s\n",
+           descriptor->size, descriptor->alignment, descriptor->variableLength ? ", variable length" : "");
 }
 
 epicsEnum16 determineRecordType(struct dbCommon* pRecord)
@@ -2770,19 +5134,19 @@ bool supplementServersNamesAndFormats(struct recordVariables *thisRecord)
 
    if (thisRecord->dimTierType == DIMSERVER)
    {
-      if (thisRecord->dimCreateBoth || ((NULL == thisRecord->dimCommandName) && (NULL == thisRecord->dimServiceName)))
+      if (thisRecord->config->dimCreateBoth || ((NULL == thisRecord->config->dimCommandName) && (NULL == thisRecord->config->dimServiceName)))
       {
-         if ((!thisRecord->dimCommandName) || (!thisRecord->dimServiceName))
+         if ((!thisRecord->config->dimCommandName) || (!thisRecord->config->dimServiceName))
          {
             /*
             * neither command name nor service name are given
             */
-            if ((!thisRecord->dimCommandName) && (!thisRecord->dimServiceName))
+            if ((!thisRecord->config->dimCommandName) && (!thisRecord->config->dimServiceName))
             {
                /*create new service name: name+suffix*/
-               address = &thisRecord->dimServiceName;
+               address = &thisRecord->config->dimServiceName;
                name    = ((struct dbCommon*)thisRecord->recordAddress)->name;
-               suffix  = thisRecord->dimGetDefaultSuffix?thisRecord->dimGetDefaultSuffix:DIMDEFAULTGETSUFFIX;
+               suffix  = thisRecord->config->dimGetDefaultSuffix?thisRecord->config->dimGetDefaultSuffix:DIMDEFAULTGETSUFFIX;
                title   = "dimServiceName";
                assert( NULL != address && NULL != name && NULL != suffix && NULL != title);
 
@@ -2794,9 +5158,9 @@ bool supplementServersNamesAndFormats(struct recordVariables *thisRecord)
                thisRecord->dimServiceExists = true;
 
                /*create new command name: name+suffix*/
-               address = &thisRecord->dimCommandName;
+               address = &thisRecord->config->dimCommandName;
                name    = ((struct dbCommon*)thisRecord->recordAddress)->name;
-               suffix  = thisRecord->dimPutDefaultSuffix?thisRecord->dimPutDefaultSuffix:DIMDEFAULTPUTSUFFIX;
+               suffix  = thisRecord->config->dimPutDefaultSuffix?thisRecord->config->dimPutDefaultSuffix:DIMDEFAULTPUTSUFFIX;
                title   = "dimCommandName";
                assert( NULL != address && NULL != name && NULL != suffix && NULL != title);
 
@@ -2812,12 +5176,12 @@ bool supplementServersNamesAndFormats(struct recordVariables *thisRecord)
                /*
                 * service name given but no command name
                 */
-               if ((!thisRecord->dimCommandName) && (thisRecord->dimServiceName))
+               if ((!thisRecord->config->dimCommandName) && (thisRecord->config->dimServiceName))
                {
                   /*create new command name: name+suffix*/
-                  address = &thisRecord->dimCommandName;
-                  name    = thisRecord->dimServiceName;
-                  suffix  = thisRecord->dimPutDefaultSuffix?thisRecord->dimPutDefaultSuffix:DIMDEFAULTPUTSUFFIX;
+                  address = &thisRecord->config->dimCommandName;
+                  name    = thisRecord->config->dimServiceName;
+                  suffix  = thisRecord->config->dimPutDefaultSuffix?thisRecord->config->dimPutDefaultSuffix:DIMDEFAULTPUTSUFFIX;
                   title   = "dimCommandName";
                   assert( NULL != address && NULL != name && NULL != suffix && NULL != title);
 
@@ -2830,9 +5194,9 @@ bool supplementServersNamesAndFormats(struct recordVariables *thisRecord)
 
                   /*extend service name: name+suffix*/
 
-                  address = &thisRecord->dimServiceName;
-                  name    = thisRecord->dimServiceName;
-                  suffix  = thisRecord->dimGetDefaultSuffix?thisRecord->dimGetDefaultSuffix:DIMDEFAULTGETSUFFIX;
+                  address = &thisRecord->config->dimServiceName;
+                  name    = thisRecord->config->dimServiceName;
+                  suffix  = thisRecord->config->dimGetDefaultSuffix?thisRecord->config->dimGetDefaultSuffix:DIMDEFAULTGETSUFFIX;
                   title   = "dimServiceName";
                   assert( NULL != address && NULL != name && NULL != suffix && NULL != title);
 
@@ -2859,12 +5223,12 @@ bool supplementServersNamesAndFormats(struct recordVariables *thisRecord)
                /*
                * command name given but no service name
                */
-               else if ((thisRecord->dimCommandName) && (!thisRecord->dimServiceName))
+               else if ((thisRecord->config->dimCommandName) && (!thisRecord->config->dimServiceName))
                {
                   /*create new service name: name+suffix*/
-                  address = &thisRecord->dimServiceName;
-                  name    = thisRecord->dimCommandName;
-                  suffix  = thisRecord->dimGetDefaultSuffix?thisRecord->dimGetDefaultSuffix:DIMDEFAULTGETSUFFIX;
+                  address = &thisRecord->config->dimServiceName;
+                  name    = thisRecord->config->dimCommandName;
+                  suffix  = thisRecord->config->dimGetDefaultSuffix?thisRecord->config->dimGetDefaultSuffix:DIMDEFAULTGETSUFFIX;
                   title   = "dimServiceName";
                   assert( NULL != address && NULL != name && NULL != suffix && NULL != title);
 
@@ -2876,9 +5240,9 @@ bool supplementServersNamesAndFormats(struct recordVariables *thisRecord)
                   thisRecord->dimServiceExists = true;
 
                   /*extend command name: name+suffix*/
-                  address = &thisRecord->dimCommandName;
-                  name    = thisRecord->dimCommandName;
-                  suffix  = thisRecord->dimPutDefaultSuffix?thisRecord->dimPutDefaultSuffix:DIMDEFAULTPUTSUFFIX;
+                  address = &thisRecord->config->dimCommandName;
+                  name    = thisRecord->config->dimCommandName;
+                  suffix  = thisRecord->config->dimPutDefaultSuffix?thisRecord->config->dimPutDefaultSuffix:DIMDEFAULTPUTSUFFIX;
                   title   = "dimCommandName";
                   assert( NULL != address && NULL != name && NULL != suffix && NULL != title);
 
@@ -2928,15 +5292,6 @@ bool recreateServersSupplementNames(char **element, char name[], char suffix[],
    /* fill */
    snprintf(newName, length, "%s%s", name, suffix);
 
-   /* reallocate */
-   *element = (char*) realloc(*element, sizeof(char) * length) ;
-   /* alloc failed ? */
-   if (! *element)
-   {
-      message(stderr,__FILE__,__LINE__,"ERROR","recreateServersSupplementNames", "couldn't (re)allocate memory\n");
-      return false;
-   }
-
    /* set new service name */
    if (false == setRecordVariablesString(element, newName, title, 0))
    {
@@ -2949,40 +5304,34 @@ bool recreateServersSupplementNames(char **element, char name[], char suffix[],
 
 bool supplementServersFormat(struct recordVariables *thisRecord)
 {
-   if ( NULL != thisRecord->dimStringTransportCommandFormat && NULL == thisRecord->dimStringTransportServiceFormat)
+   if ( NULL != thisRecord->config->dimStringTransportCommandFormat && NULL == thisRecord->config->dimStringTransportServiceFormat)
    {
       /* copy format from Command to Service */
-      if ( NULL != thisRecord->dimStringTransportCommandFormat)
+      if ( NULL != thisRecord->config->dimStringTransportCommandFormat)
       {
          /* copy format from Command to Service */
-         if (! setRecordVariablesString(&(thisRecord->dimStringTransportServiceFormat), thisRecord->dimStringTransportCommandFormat, "dimStringTransportServiceFormat", '\"'))
+         if (! setRecordVariablesInternedString(&(thisRecord->config->dimStringTransportServiceFormat), thisRecord->config->dimStringTransportCommandFormat, "dimStringTransportServiceFormat", '\"'))
          {
             message(stderr,__FILE__,__LINE__,"ERROR","supplementServersFormat", "setRecordVariablesString failed\n");
             return false;
          }
 
-         if (!disassembleFormat(thisRecord->dimStringTransportServiceFormat,
-                                &thisRecord->dimStringTransportNumberOfServiceFormats,
-                                &thisRecord->dimStringTransportServiceDataTypes,
-                                &thisRecord->dimStringTransportNumberOfServiceDataTypesPerFormat))
+         if (!disassembleFormat(thisRecord->config->dimStringTransportServiceFormat, &thisRecord->config->dimStringTransportServiceFormatDescriptor))
          {
             message(stderr,__FILE__,__LINE__,"ERROR","supplementServersFormat", "disassembleFormat() failed");
             return false;
          }
       }
-      if ( NULL == thisRecord->dimStringTransportCommandFormat && NULL != thisRecord->dimStringTransportServiceFormat)
+      if ( NULL == thisRecord->config->dimStringTransportCommandFormat && NULL != thisRecord->config->dimStringTransportServiceFormat)
       {
          /* copy format from Service to Command */
-         if (! setRecordVariablesString(&(thisRecord->dimStringTransportCommandFormat), thisRecord->dimStringTransportServiceFormat, "dimStringTransportCommandFormat", '\"'))
+         if (! setRecordVariablesInternedString(&(thisRecord->config->dimStringTransportCommandFormat), thisRecord->config->dimStringTransportServiceFormat, "dimStringTransportCommandFormat", '\"'))
          {
             message(stderr,__FILE__,__LINE__,"ERROR","supplementServersFormat", "setRecordVariablesString failed\n");
             return false;
          }
 
-         if (!disassembleFormat(thisRecord->dimStringTransportCommandFormat,
-                                &thisRecord->dimStringTransportNumberOfCommandFormats,
-                                &thisRecord->dimStringTransportCommandDataTypes,
-                                &thisRecord->dimStringTransportNumberOfCommandDataTypesPerFormat))
+         if (!disassembleFormat(thisRecord->config->dimStringTransportCommandFormat, &thisRecord->config->dimStringTransportCommandFormatDescriptor))
          {
             message(stderr,__FILE__,__LINE__,"ERROR","supplementServersFormat", "disassembleFormat() failed");
             return false;
@@ -2994,40 +5343,34 @@ bool supplementServersFormat(struct recordVariables *thisRecord)
 
 bool supplementStringTransportServersFormat(struct recordVariables *thisRecord)
 {
-   if (( true == thisRecord->stringTransportCommand ) || (true == thisRecord->stringTransportService))
+   if (( true == thisRecord->config->stringTransportCommand ) || (true == thisRecord->config->stringTransportService))
    {
       /* copy format from Command to Service */
-      if ( NULL != thisRecord->dimStringTransportCommandFormat && NULL == thisRecord->dimStringTransportServiceFormat)
+      if ( NULL != thisRecord->config->dimStringTransportCommandFormat && NULL == thisRecord->config->dimStringTransportServiceFormat)
       {
          /* copy format from Command to Service */
-         if (! setRecordVariablesString(&(thisRecord->dimStringTransportServiceFormat), thisRecord->dimStringTransportCommandFormat, "dimStringTransportServiceFormat", '\"'))
+         if (! setRecordVariablesInternedString(&(thisRecord->config->dimStringTransportServiceFormat), thisRecord->config->dimStringTransportCommandFormat, "dimStringTransportServiceFormat", '\"'))
          {
             message(stderr,__FILE__,__LINE__,"ERROR","supplementStringTransportServersFormat", "setRecordVariablesString failed\n");
             return false;
          }
 
-         if (!disassembleFormat(thisRecord->dimStringTransportServiceFormat,
-                                &thisRecord->dimStringTransportNumberOfServiceFormats,
-                                &thisRecord->dimStringTransportServiceDataTypes,
-                                &thisRecord->dimStringTransportNumberOfServiceDataTypesPerFormat))
+         if (!disassembleFormat(thisRecord->config->dimStringTransportServiceFormat, &thisRecord->config->dimStringTransportServiceFormatDescriptor))
          {
             message(stderr,__FILE__,__LINE__,"ERROR","supplementStringTransportServersFormat", "disassembleFormat() failed");
             return false;
          }
       }
-      if ( NULL == thisRecord->dimStringTransportCommandFormat && NULL != thisRecord->dimStringTransportServiceFormat)
+      if ( NULL == thisRecord->config->dimStringTransportCommandFormat && NULL != thisRecord->config->dimStringTransportServiceFormat)
       {
          /* copy format from Service to Command */
-         if (! setRecordVariablesString(&(thisRecord->dimStringTransportCommandFormat), thisRecord->dimStringTransportServiceFormat, "dimStringTransportCommandFormat", '\"'))
+         if (! setRecordVariablesInternedString(&(thisRecord->config->dimStringTransportCommandFormat), thisRecord->config->dimStringTransportServiceFormat, "dimStringTransportCommandFormat", '\"'))
          {
             message(stderr,__FILE__,__LINE__,"ERROR","supplementStringTransportServersFormat", "setRecordVariablesString failed\n");
             return false;
          }
 
-         if (!disassembleFormat(thisRecord->dimStringTransportCommandFormat,
-                                &thisRecord->dimStringTransportNumberOfCommandFormats,
-                                &thisRecord->dimStringTransportCommandDataTypes,
-                                &thisRecord->dimStringTransportNumberOfCommandDataTypesPerFormat))
+         if (!disassembleFormat(thisRecord->config->dimStringTransportCommandFormat, &thisRecord->config->dimStringTransportCommandFormatDescriptor))
          {
             message(stderr,__FILE__,__LINE__,"ERROR","supplementStringTransportServersFormat", "disassembleFormat() failed");
             return false;
@@ -3050,7 +5393,7 @@ bool setCombinedDnsAddressAndPort(struct recordVariables* thisRecord, char argum
    found_elements = divideUpStrings (&argument[0], &argArray, ":", 2, DIM_TOKEN_PROTECTION);
    if (2 == found_elements || 1 == found_elements)
    {
-      if (! setRecordVariablesString(&(thisRecord->dimDnsAddress), argArray[0], "dimDnsAddress", DIMDNSADDRESS) )
+      if (! setRecordVariablesInternedString(&(thisRecord->config->dimDnsAddress), argArray[0], "dimDnsAddress", DIMDNSADDRESS) )
       {
          returnValue = false;
       }
@@ -3058,10 +5401,10 @@ bool setCombinedDnsAddressAndPort(struct recordVariables* thisRecord, char argum
       {
          if (2 == found_elements)
          {
-            if (0 <= thisRecord->dimDnsPort)
+            if (0 <= thisRecord->config->dimDnsPort)
             {
                message(stderr,__FILE__,__LINE__,"ERROR","setCombinedDnsAddressAndPort", "dns port is already set to %i, what to choose? ... returning NULL\n",
-                       thisRecord->dimDnsPort);
+                       thisRecord->config->dimDnsPort);
                return false;
             }
             else
@@ -3074,7 +5417,7 @@ bool setCombinedDnsAddressAndPort(struct recordVariables* thisRecord, char argum
                }
                else
                {
-                  thisRecord->dimDnsPort = atoi(argArray[1]);
+                  thisRecord->config->dimDnsPort = atoi(argArray[1]);
                }
             }
          }
@@ -3113,10 +5456,10 @@ bool setCombinedClientServiceScanTypeAndInterval(struct recordVariables* thisRec
       switch(argArray[0][0])
       {
       case DIMSCANTYPETIMED:
-         thisRecord->dimServiceScanType = TIMED;
+         thisRecord->config->dimServiceScanType = TIMED;
          break;
       case DIMSCANTYPEMONITORED:
-         thisRecord->dimServiceScanType = MONITORED;
+         thisRecord->config->dimServiceScanType = MONITORED;
          break;
       default:
          message(stderr,__FILE__,__LINE__,"ERROR","setCombinedClientServiceScanTypeAndInterval", "`%s' is not a valid scan mode only '%c' or '%c' are allowed ... returning false\n",
@@ -3126,10 +5469,10 @@ bool setCombinedClientServiceScanTypeAndInterval(struct recordVariables* thisRec
       }
       if (2 == found_elements)
       {
-         if (0 <= thisRecord->dimServiceScanInterval)
+         if (0 <= thisRecord->config->dimServiceScanInterval)
          {
             message(stderr,__FILE__,__LINE__,"ERROR","setCombinedClientServiceScanTypeAndInterval", "clients service scan interval (timeout) already set to %i, what to choose? ... returning NULL\n",
-                    thisRecord->dimServiceScanInterval);
+                    thisRecord->config->dimServiceScanInterval);
             returnValue = false;
          }
          else
@@ -3143,7 +5486,7 @@ bool setCombinedClientServiceScanTypeAndInterval(struct recordVariables* thisRec
             }
             else
             {
-               thisRecord->dimServiceScanInterval=atoi(argArray[1]);
+               thisRecord->config->dimServiceScanInterval=atoi(argArray[1]);
             }
          }
       }
@@ -3237,14 +5580,14 @@ bool setDnsPort(struct recordVariables *thisRecord)
    int port = -1;
    int returnValue = 0;
 
-   if (-1 != thisRecord->dimDnsPort)
+   if (-1 != thisRecord->config->dimDnsPort)
    {
       if (DIMSERVER == thisRecord->dimTierType)
       {
          if (false == dimServerDnsPortSet)
          {
             returnValue = 0;
-            returnValue = dis_set_dns_port(thisRecord->dimDnsPort);
+            returnValue = dis_set_dns_port(thisRecord->config->dimDnsPort);
             if (1 != returnValue)
             {
                message(stderr,__FILE__,__LINE__,"ERROR","setDnsPort()", "dis_set_dns_port failed\n");
@@ -3257,10 +5600,10 @@ bool setDnsPort(struct recordVariables *thisRecord)
             port = -1;
             port = dis_get_dns_port();
 
-            if (port != thisRecord->dimDnsPort)
+            if (port != thisRecord->config->dimDnsPort)
             {
                message(stderr,__FILE__,__LINE__,"ERROR","setDnsPort()", "servers' port is already set to %i, cannot set %i\n",
-                       port, thisRecord->dimDnsPort);
+                       port, thisRecord->config->dimDnsPort);
                return false;
             }
          }
@@ -3270,7 +5613,7 @@ bool setDnsPort(struct recordVariables *thisRecord)
          if (false == dimClientDnsPortSet)
          {
             returnValue = 0;
-            returnValue = dic_set_dns_port(thisRecord->dimDnsPort);
+            returnValue = dic_set_dns_port(thisRecord->config->dimDnsPort);
             if (1 != returnValue)
             {
                message(stderr,__FILE__,__LINE__,"ERROR","setDnsPort()", "dic_set_dns_port failed\n");
@@ -3283,16 +5626,16 @@ bool setDnsPort(struct recordVariables *thisRecord)
             port = -1;
             port = dic_get_dns_port();
 
-            if (port != thisRecord->dimDnsPort)
+            if (port != thisRecord->config->dimDnsPort)
             {
                message(stderr,__FILE__,__LINE__,"ERROR","setDnsPort()", "clients' port is already set to %i, cannot set %i\n",
-                       port, thisRecord->dimDnsPort);
+                       port, thisRecord->config->dimDnsPort);
                return false;
             }
          }
       }
    }
-   else /*(-1 == thisRecord->dimDnsPort)*/
+   else /*(-1 == thisRecord->config->dimDnsPort)*/
    {
       /*
       * cancel if environment variable is not set
@@ -3310,7 +5653,7 @@ bool setDnsPort(struct recordVariables *thisRecord)
       * set dns port to struct
       */
 
-      thisRecord->dimDnsPort = port;
+      thisRecord->config->dimDnsPort = port;
       /* setting globals */
       if ( DIMSERVER == thisRecord->dimTierType)
       {
@@ -3333,14 +5676,14 @@ bool setDnsAddress(struct recordVariables *thisRecord)
    */
    int returnValue = 0;
    char dns_node_name[255] = {'\0'};
-   if (NULL != thisRecord->dimDnsAddress)
+   if (NULL != thisRecord->config->dimDnsAddress)
    {
       if (DIMSERVER == thisRecord->dimTierType)
       {
          if (false == dimServerDnsAddressSet)
          {
             returnValue = 0;
-            returnValue = dis_set_dns_node(thisRecord->dimDnsAddress);
+            returnValue = dis_set_dns_node(thisRecord->config->dimDnsAddress);
             if (1 != returnValue)
             {
                message(stderr,__FILE__,__LINE__,"ERROR","setDnsAddress()", "dis_set_dns_node failed\n");
@@ -3359,24 +5702,24 @@ bool setDnsAddress(struct recordVariables *thisRecord)
             }
 
             /* check if dimDnsAdress is already part of dns_node_name */
-            if (NULL == strstr(dns_node_name,&thisRecord->dimDnsAddress[0]))
+            if (NULL == strstr(dns_node_name,&thisRecord->config->dimDnsAddress[0]))
             {
                /* attach at the end of the search path*/
                /* warning */
                message(stderr,__FILE__,__LINE__,"WARNING","setDnsAdress()", "servers' dim Dns Address already set to `%s', attaching `%s' at the end\n",
-                       dns_node_name, thisRecord->dimDnsAddress);
+                       dns_node_name, thisRecord->config->dimDnsAddress);
 
                /* check maximum length */
-               if ( MAXIMUMDIMDNSADDRESSLENGTH < strlen(dns_node_name) + strlen(",") + strlen(thisRecord->dimDnsAddress)) /*string too long*/
+               if ( MAXIMUMDIMDNSADDRESSLENGTH < strlen(dns_node_name) + strlen(",") + strlen(thisRecord->config->dimDnsAddress)) /*string too long*/
                {
                   message(stderr,__FILE__,__LINE__,"ERROR","setDnsAdress()", "`%s,%s' is too long, max length: %i\n",
-                          dns_node_name,thisRecord->dimDnsAddress, MAXIMUMDIMDNSADDRESSLENGTH);
+                          dns_node_name,thisRecord->config->dimDnsAddress, MAXIMUMDIMDNSADDRESSLENGTH);
                   return false;
                }
 
                /* attach at the end of the search path*/
                strcat(dns_node_name, ",");
-               strcat(dns_node_name, thisRecord->dimDnsAddress);
+               strcat(dns_node_name, thisRecord->config->dimDnsAddress);
                returnValue = 0;
                returnValue = dis_set_dns_node(dns_node_name);
                if (1 != returnValue)
@@ -3392,7 +5735,7 @@ bool setDnsAddress(struct recordVariables *thisRecord)
          if (false == dimClientDnsAddressSet)
          {
             returnValue = 0;
-            returnValue = dic_set_dns_node(thisRecord->dimDnsAddress);
+            returnValue = dic_set_dns_node(thisRecord->config->dimDnsAddress);
             if (1 != returnValue)
             {
                message(stderr,__FILE__,__LINE__,"ERROR","setDnsAddress()", "dic_set_dns_node failed\n");
@@ -3411,24 +5754,24 @@ bool setDnsAddress(struct recordVariables *thisRecord)
             }
 
             /* check if dimDnsAdress is already part of dns_node_name */
-            if (NULL == strstr(dns_node_name,&thisRecord->dimDnsAddress[0]))
+            if (NULL == strstr(dns_node_name,&thisRecord->config->dimDnsAddress[0]))
             {
                /* attach at the end of the search path*/
                /* warning */
                message(stderr,__FILE__,__LINE__,"WARNING","setDnsAdress()", "clients' dim Dns Address already set to `%s', attaching `%s' at the end",
-                       dns_node_name, thisRecord->dimDnsAddress);
+                       dns_node_name, thisRecord->config->dimDnsAddress);
 
                /* check maximum length */
-               if ( MAXIMUMDIMDNSADDRESSLENGTH < strlen(dns_node_name) + strlen(",") + strlen(thisRecord->dimDnsAddress)) /*string too long*/
+               if ( MAXIMUMDIMDNSADDRESSLENGTH < strlen(dns_node_name) + strlen(",") + strlen(thisRecord->config->dimDnsAddress)) /*string too long*/
                {
                   message(stderr,__FILE__,__LINE__,"ERROR","setDnsAdress()", "`%s,%s' is too long, max length: %i\n",
-                          dns_node_name,thisRecord->dimDnsAddress, MAXIMUMDIMDNSADDRESSLENGTH);
+                          dns_node_name,thisRecord->config->dimDnsAddress, MAXIMUMDIMDNSADDRESSLENGTH);
                   return false;
                }
 
                /* attach at the end of the search path*/
                strcat(dns_node_name, ",");
-               strcat(dns_node_name, thisRecord->dimDnsAddress);
+               strcat(dns_node_name, thisRecord->config->dimDnsAddress);
                returnValue = 0;
                returnValue = dic_set_dns_node(dns_node_name);
                if (1 != returnValue)
@@ -3440,7 +5783,7 @@ bool setDnsAddress(struct recordVariables *thisRecord)
          }
       }
    }
-   else /*(NULL == thisRecord->dimDnsAddress)*/
+   else /*(NULL == thisRecord->config->dimDnsAddress)*/
    {
       /*
       * cancel if environment variable is not set
@@ -3464,8 +5807,10 @@ bool setDnsAddress(struct recordVariables *thisRecord)
       /*
       * set dns address to struct
       */
-      thisRecord->dimDnsAddress = (char*) malloc (sizeof(char) * (1 +  strlen(dns_node_name)));
-      strncpy(thisRecord->dimDnsAddress, dns_node_name, (1+strlen(dns_node_name)));
+      if (NULL == setRecordVariablesInternedString(&thisRecord->config->dimDnsAddress, dns_node_name, "dimDnsAddress", 0))
+      {
+         return false;
+      }
       /* setting globals */
       if ( DIMSERVER == thisRecord->dimTierType)
       {
@@ -8,68 +8,253 @@ bool makeServerName(struct dbCommon* pRecord);
 int errorDeactivateRecord(struct dbCommon *pRecord, int line, char* fcn, char* format, ... );
 
 char* setRecordVariablesString(char **element, char argument[], char discription[], char key);
+char* setHeapString(char **element, char argument[], char discription[], char key);
+void* recordAlloc(size_t size);
+char* internString(char string[]);
+char* setRecordVariablesInternedString(char **element, char argument[], char discription[], char key);
+bool initRecordArena(int numberOfRecords);
+bool initRecordPool(int numberOfRecords);
+struct recordVariables* recordPoolAlloc(void);
+void releaseRecordArena(void *arg);
+void releaseMessageLogger(void *arg);
 
-typedef struct recordVariables
+typedef void (*dimToEpicsKernel)(const void *dimData, double *val, epicsInt32 *rval);
+typedef void (*epicsToDimKernel)(void *dimData, const double *val, epicsInt32 *rval);
+typedef void (*arrayKernel)(void *dst, const void *src, unsigned long n);
+
+/*
+ * compiled DIM format, e.g. "I:2;D:4;C":
+ * one element per type, laid out like the corresponding C struct
+ */
+typedef struct dimFormatElement
+{
+   char type;
+   unsigned int count;   /* 0: any (last element only) */
+   unsigned int offset;  /* bytes */
+   unsigned int size;    /* bytes of one item */
+} dimFormatElement;
+
+typedef struct dimFormatDescriptor
+{
+   unsigned int numberOfElements;
+   unsigned int size;    /* bytes, variable last element not included */
+   unsigned int alignment;
+   bool variableLength;
+   struct dimFormatElement elements[];
+} dimFormatDescriptor;
+
+#ifndef DIMLATENCYBINS
+#define DIMLATENCYBINS 24 /* log2 of us from the DIM callback to process(), last bin: >= 2^22 us */
+#endif
+
+/*
+ * counters of a record, summed up per service and per DNS node by report()
+ */
+typedef struct dimStatistics
+{
+   char *name;
+   int   numberOfRecords;
+   unsigned long callbacks;            /* updates and commands received from DIM */
+   unsigned long bytes;                /* copied into the mailbox */
+   unsigned long processed;            /* processings with data received */
+   unsigned long commandsSent;
+   unsigned long commandsFailed;
+   unsigned long disconnects;
+   unsigned long latency[DIMLATENCYBINS];
+} dimStatistics;
+
+/*
+ * subscription to a client service shared by several records,
+ * each subscriber receives its slice of the data
+ */
+typedef struct dimSubscriber
+{
+   struct recordVariables *record;
+   unsigned int offset;
+   unsigned int size;
+   bool formatChanged;                 /* s. refreshFormatCache() */
+} dimSubscriber;
+
+typedef struct dimSubscription
+{
+   struct dimSubscriber *subscribers;
+   int   numberOfSubscribers;
+   unsigned int serviceID;
+   unsigned int index;                 /* DIM tag */
+   bool  serviceOk;
+   unsigned long updates;
+   char *key;
+   char *serviceName;
+   int   scanType;
+   int   scanInterval;
+   struct dimFormatDescriptor *descriptor;
+} dimSubscription;
+
+/*
+ * served records publishing as one struct service (@Sg),
+ * the generated format lists the members' formats in order of initialisation
+ */
+typedef struct dimServiceGroup
+{
+   struct recordVariables **members;
+   int   numberOfMembers;
+   unsigned int index;                 /* DIM tag */
+   unsigned int serviceID;
+   char *name;
+   char *format;
+   struct dimFormatDescriptor *descriptor;
+   void *buffer;                       /* written by the members */
+   void *published[2];                 /* snapshots, the front one is sent by DIM */
+   int   publishedFront;
+   unsigned int size;
+   int   period;                       /* s, 0: published on every change */
+   bool  changed;
+   epicsMutexId lock;                  /* buffer, front */
+   epicsMutexId publishLock;           /* one snapshot and its dis_update_service() at a time */
+   unsigned long updates;
+} dimServiceGroup;
+
+/*
+ * counters of a record, each written by one thread only (DIM or the record's processing)
+ * or incremented atomically, read by report() and the statistics records
+ */
+typedef struct recordCounters
+{
+   unsigned long updatesMerged;
+   unsigned long updatesDropped;
+   unsigned long commandsFailed;
+   unsigned long callbacks;
+   unsigned long bytesReceived;
+   unsigned long processed;
+   unsigned long commandsSent;
+   unsigned long disconnects;
+   unsigned long latency[DIMLATENCYBINS];
+}
+recordCounters;
+
+/*
+ * configuration of a record: set up by init_record(),
+ * afterwards only read by dumpStruct() and for error messages,
+ * the callback structs are only handed to the callback queue
+ */
+typedef struct recordConfiguration
 {
-   void *dimData;
-   unsigned int dataSize;
-   void *recordAddress;
-   unsigned int   index;
-   int   dimCommandServiceID;
-   int   dimServiceServiceID;
-   char  dimTierType;
-   int   calledFromCallback;
    char *dimCommandName;
    char *dimServiceName;
    char *dimCommandFormat;
    char *dimServiceFormat;
-   char *dimServiceDataTypes;
-   char *dimCommandDataTypes;
-   unsigned int dimNumberOfServiceFormats;
-   unsigned int dimNumberOfCommandFormats;
-   unsigned int *dimNumberOfServiceDataTypesPerFormat;
-   unsigned int *dimNumberOfCommandDataTypesPerFormat;
+   struct dimFormatDescriptor *dimServiceFormatDescriptor;
+   struct dimFormatDescriptor *dimCommandFormatDescriptor;
    char *dimDnsAddress;
-   int   dimDnsPort;
    char *recordType;
-   int   recordTypeIndex;
    char *dimServicesNamePrefix;
-   bool  dimServiceExists;
-   bool  dimCommandExists;
-   char* dimGetDefaultSuffix;
-   char* dimPutDefaultSuffix;
-   int dimServiceScanType;
-   int dimServiceScanInterval;
-   bool clientServiceCallbackOk;
-   bool serverCommandCallbackOk;
+   char *dimGetDefaultSuffix;
+   char *dimPutDefaultSuffix;
+   char *dimStringTransportCommandFormat;
+   char *dimStringTransportServiceFormat;
+   struct dimFormatDescriptor *dimStringTransportServiceFormatDescriptor;
+   struct dimFormatDescriptor *dimStringTransportCommandFormatDescriptor;
+
+   int   dimDnsPort;
+   int   dimServiceElement;          /* @Se: element of the service's struct, -1: all */
+   unsigned int dimServiceElementOffset;
+   struct dimFormatDescriptor *dimServiceStructDescriptor;
+   struct dimSubscription *dimSubscription;
+   char *dimServiceGroupName;
+   int   dimServiceGroupPeriod;
+   int   dimServiceScanType;
+   int   dimServiceScanInterval;
 
    bool stringTransportCommand;
    bool stringTransportService;
    bool stringTransportBoth;
-   char *dimStringTransportCommandFormat;
-   char *dimStringTransportServiceFormat;
-   char *dimStringTransportServiceDataTypes;
-   char *dimStringTransportCommandDataTypes;
-   unsigned int dimStringTransportNumberOfServiceFormats;
-   unsigned int dimStringTransportNumberOfCommandFormats;
-   unsigned int *dimStringTransportNumberOfServiceDataTypesPerFormat;
-   unsigned int *dimStringTransportNumberOfCommandDataTypesPerFormat;
-
    bool dimCreateBoth;
+
+   CALLBACK processCallback;
+   CALLBACK commandCallback;
+}
+recordConfiguration;
+
+/*
+ * state of a record used by process(), the DIM callbacks and the service routine,
+ * ordered by size (no padding), the fields used on every update first,
+ * counters and configuration are reached via pointers,
+ * the structs are kept in one contiguous array (s. initRecordPool())
+ */
+typedef struct recordVariables
+{
+   void *dimData;
+   void *recordAddress;
+   IOSCANPVT ioScanPvt;
+   dimToEpicsKernel copyDimToEpics;
+   epicsToDimKernel copyEpicsToDim;
+   double     *epicsValue;
+   epicsInt32 *epicsRawValue;
+   arrayKernel copyDimToEpicsArray;
+   arrayKernel copyEpicsToDimArray;
+   struct mailbox dimMailbox;
+   unsigned long long callbackTime;    /* ns, monotonic, latest update received */
+   struct recordCounters *counters;
+   struct dimServiceGroup *serviceGroup;
+   void *dimServiceBuffer[2];          /* served services */
+   struct recordConfiguration *config;
+   unsigned int dataSize;
+   unsigned int dimDataReceivedSize;
+   unsigned int dimDataSendSize;
+   unsigned int dimElementSize;
+   unsigned int serviceGroupOffset;
+   unsigned int dimServiceBufferSize[2];
+   unsigned int index;
+   unsigned int processRequestTime;    /* ms, monotonic (wraps), coalescing: latest processing requested */
+   int   calledFromCallback;           /* 1: data in the mailbox not yet processed */
+   int   commandPending;
+   int   commandReturnCode;
+   int   dimCommandServiceID;
+   int   dimServiceServiceID;
+   int   dimServiceFront;
+   int   recordTypeIndex;
+   char  dimTierType;
+   bool  dimServiceExists;
+   bool  dimCommandExists;
+   bool  clientServiceCallbackOk;
+   bool  serverCommandCallbackOk;
+   bool  coalesceUpdates;
+   bool  asyncCommand;
+   bool  zeroCopy;
 }
 recordVariables;
+
+#ifndef DIMRECORDVARIABLESMAXIMUMSIZE
+#define DIMRECORDVARIABLESMAXIMUMSIZE 256 /* bytes, four cache lines */
+#endif
+/* compile time checks: recordVariables fits DIMRECORDVARIABLESMAXIMUMSIZE, no padding at its end */
+typedef char recordVariablesSizeCheck[(sizeof(struct recordVariables) <= DIMRECORDVARIABLESMAXIMUMSIZE) ? 1 : -1];
+typedef char recordVariablesPaddingCheck[(offsetof(struct recordVariables, zeroCopy) + sizeof(bool) == sizeof(struct recordVariables)) ? 1 : -1];
 /*recordVariables wenn ich das hier an und aus mache erscheint im outline irgendwie ein gelbes T Symbol.
  * Was ist der Unterschied??*/
 
 void dumpStruct ( struct recordVariables *rec, FILE *stream );
+unsigned long long monotonicTime(void);
+void recordLatency(struct recordVariables *thisRecord);
+void addStatistics(struct dimStatistics *statistics, struct recordVariables *thisRecord);
+void reportStatistics(struct dimStatistics *statistics, int level);
+void reportStatisticsBy(int level, bool byDnsNode);
+void dimReport(int level);
+void updateStatistics(void);
+double latencyPercentile(unsigned long histogram[], double fraction);
+void dumpRecordSummary ( struct recordVariables *rec, FILE *stream );
+void dimDumpRecord(char *recordName);
 recordVariables* createAndInitVariables( struct dbCommon	*pRecord );
 void clearStructRecordVariables( struct recordVariables *thisRecord );
 epicsEnum16 determineRecordType(struct dbCommon* pRecord);
 bool checkValidType(char *type);
-bool disassembleFormat(char formatString[],
-                       unsigned int* dimNumberOfCommandFormats,
-                       char** dimCommandDataTypes,
-                       unsigned int** dimNumberOfCommandDataTypesPerFormat );
+bool disassembleFormat(char formatString[], struct dimFormatDescriptor **descriptor);
+struct dimFormatDescriptor* compileFormat(char formatString[]);
+unsigned int dimDataTypeSize(char dimDataType);
+unsigned int formatDataSize(struct dimFormatDescriptor *descriptor);
+bool equalFormatDescriptors(struct dimFormatDescriptor *first, struct dimFormatDescriptor *second);
+bool setFormatDescriptorNumberOfElements(struct dimFormatDescriptor **descriptor, unsigned int numberOfElements);
+void dumpFormatDescriptor(FILE *stream, char title[], struct dimFormatDescriptor *descriptor);
 bool supplementServersNamesAndFormats(struct recordVariables *thisRecord);
 bool supplementServersFormat(struct recordVariables *thisRecord);
 bool supplementStringTransportServersFormat(struct recordVariables *thisRecord);
@@ -79,19 +264,70 @@ bool setCombinedClientServiceScanTypeAndInterval(struct recordVariables* thisRec
 bool checkValidUnsignedInt(char arg[]);
 bool setDnsAddress(struct recordVariables *thisRecord);
 bool setDnsPort(struct recordVariables *thisRecord);
+bool resolveConversionKernels(struct recordVariables *thisRecord);
+bool resolveArrayConversionKernels(struct recordVariables *thisRecord, char dimDataType);
+char ftvlDefaultDIMDataType(epicsEnum16 ftvl);
+bool setArrayDefaultNumberOfElements(struct recordVariables *thisRecord);
 long copyEpicsToDimData(struct recordVariables *thisRecord);
 long copyDimToEpicsData(struct recordVariables *thisRecord);
-unsigned int calculateDataSize(unsigned int numberOfFormats,
-                               char dataTypes[],
-                               unsigned int numberOfDataTypesPerFormat[]);
 unsigned int determineDataSize(struct recordVariables *thisRecord);
 bool checkConsistencyFormatTypes(struct recordVariables *thisRecord);
 bool checkConsistencyRecordSpecific(struct recordVariables *thisRecord);
 bool addServersPrefix(struct recordVariables *thisRecord);
 bool setServersDefaultDataFormat(struct recordVariables *thisRecord);
-bool getServiceFormat(char *serviceFormat, struct recordVariables *thisRecord);
-bool getCommandFormat(char *serviceFormat, struct recordVariables *thisRecord);
+bool getServiceFormat(char **serviceFormat, struct recordVariables *thisRecord);
+bool getCommandFormat(char **commandFormat, struct recordVariables *thisRecord);
+bool getFormat(char **format, char *name, struct recordVariables *thisRecord);
+void dimDnsNodeKey(char node[], const char dnsAddress[]);
+bool queryDimFormat(char **format, char *name);
+
+typedef struct formatQuery
+{
+   char *name;
+   char *node;
+   char *key;
+   char *format;
+   unsigned id;
+   int   fill;
+   int  *outstanding;
+   epicsEventId done;
+} formatQuery;
+
+bool queryDimFormats(struct formatQuery queries[], int numberOfQueries);
+bool preResolveInputOutput(char inputOutputField[], struct formatQuery **queries, int *numberOfQueries, void *pending);
+int preResolveFormats(void);
+
+typedef struct formatCacheEntry
+{
+   char *key;
+   char *name;
+   char *node;
+   char *format;
+   bool  used;
+   bool  changed;
+} formatCacheEntry;
+
+struct formatCacheEntry* findFormatCacheEntry(char *name, char *node);
+struct formatCacheEntry* addFormatCacheEntry(char *name, char *node, char *format);
+bool readFormatCache(char *fileName);
+bool writeFormatCache(char *fileName);
+void refreshFormatCache(void *arg);
+int invalidateFormatRecords(struct formatCacheEntry *entry);
+void dimSetFormatCache(char *fileName);
 bool retrieveAndSetClientServicesFormat(struct recordVariables *thisRecord);
+bool selectServiceElement(struct recordVariables *thisRecord);
+struct dimSubscription* subscribeService(struct recordVariables *thisRecord);
+bool startSubscriptions(void);
+void dimSubscriptionCallback(long *tag, int *data, int *size);
+void notifyRecord(struct recordVariables *calledBackRecord);
+void requestProcessing(struct recordVariables *thisRecord);
+bool setServiceGroup(struct recordVariables *thisRecord, char argument[]);
+struct dimServiceGroup* joinServiceGroup(struct recordVariables *thisRecord);
+bool startServiceGroups(void);
+void publishService(struct recordVariables *thisRecord);
+void publishServiceGroup(struct dimServiceGroup *group);
+void dimServiceGroupRoutine(long *tag, int **address, int *size);
+void servicePublishingThread(void *arg);
 
 typedef enum {
    DIMaiRecord
@@ -131,6 +367,37 @@ char *DIMInterfaceSupportedRecordNames [DIMLastDummyEntry] =
       /*	,"genSub" */
    };
 
+/* driver statistics, ai records with DTYP "caDIMInterfaceStatistics" and INP "@<name>" */
+typedef enum {
+   DIMStatisticsRecords
+   ,DIMStatisticsCallbackRate
+   ,DIMStatisticsProcessRate
+   ,DIMStatisticsByteRate
+   ,DIMStatisticsLatencyP50
+   ,DIMStatisticsLatencyP90
+   ,DIMStatisticsLatencyP99
+   ,DIMStatisticsPendingProcessing
+   ,DIMStatisticsMessageQueue
+   ,DIMStatisticsDisconnectedServices
+   ,DIMStatisticsCommandsFailed
+   ,DIMStatisticsLastDummyEntry
+} DIMInterfaceStatistics;
+
+char *DIMInterfaceStatisticsNames [DIMStatisticsLastDummyEntry] =
+   {
+      "records"
+      ,"callbackRate"
+      ,"processRate"
+      ,"byteRate"
+      ,"latencyP50"
+      ,"latencyP90"
+      ,"latencyP99"
+      ,"pendingProcessing"
+      ,"messageQueue"
+      ,"disconnectedServices"
+      ,"commandsFailed"
+   };
+
 typedef enum {
    DIMDataTypeChar
    ,DIMDataTypeInt
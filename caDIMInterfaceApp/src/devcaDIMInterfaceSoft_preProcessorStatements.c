@@ -40,6 +40,15 @@
 #ifndef DIMEXTENSIONSCREATEBOTH      
 #define DIMEXTENSIONSCREATEBOTH            'b'
 #endif
+#ifndef DIMEXTENSIONSCOALESCE
+#define DIMEXTENSIONSCOALESCE              'm'
+#endif
+#ifndef DIMEXTENSIONSASYNCCOMMAND
+#define DIMEXTENSIONSASYNCCOMMAND          'a'
+#endif
+#ifndef DIMEXTENSIONSZEROCOPY
+#define DIMEXTENSIONSZEROCOPY              'z'
+#endif
 #ifndef DIMEXTENSIONSTRINGTRANSPORTSERVICE
 #define DIMEXTENSIONSTRINGTRANSPORTSERVICE 's'
 #endif
@@ -127,3 +136,55 @@
 #ifndef DIMSTRINGDEFAULTDATATYPE
 #define DIMSTRINGDEFAULTDATATYPE "C:40"
 #endif
+
+#ifndef DIMFORMATTIMEOUT
+#define DIMFORMATTIMEOUT 5 /* s, format lookup of a service */
+#endif
+
+#ifndef DIMFORMATCACHEKEYSEPARATOR
+#define DIMFORMATCACHEKEYSEPARATOR "@"
+#endif
+
+#ifndef DIMCOALESCETIMEOUT
+#define DIMCOALESCETIMEOUT 1000 /* ms, coalescing: a processing requested but not executed is requested again */
+#endif
+
+#ifndef DIMDEVICETYPE
+#define DIMDEVICETYPE "caDIMInterface"
+#endif
+
+#ifndef DIMMAXIMUMNUMBEROFKEYS
+#define DIMMAXIMUMNUMBEROFKEYS 64 /* @key=argument elements of one INP/OUT string */
+#endif
+
+#ifndef DIMLINKTOKENS
+#define DIMLINKTOKENS DIM_PRIMARY_TOKEN DIM_SECONDARY_TOKEN DIM_THIRD_TOKEN
+#endif
+
+#ifndef DIMARENABYTESPERRECORD
+#define DIMARENABYTESPERRECORD 1024 /* configuration, counters, strings and format arrays, estimate */
+#endif
+
+#ifndef DIMARENAMINIMUMBLOCKSIZE
+#define DIMARENAMINIMUMBLOCKSIZE 16384
+#endif
+
+#ifndef DIMSERVICEELEMENT
+#define DIMSERVICEELEMENT 'e' /* @Se=<index>: one element of a struct service */
+#endif
+
+#ifndef DIMMESSAGESLOTS
+#define DIMMESSAGESLOTS 1024 /* messages queued for the writer thread, s. startMessageLogger() */
+#endif
+
+#ifndef DIMSTATISTICSDEVICETYPE
+#define DIMSTATISTICSDEVICETYPE "caDIMInterfaceStatistics"
+#endif
+
+#ifndef DIMSTATISTICSMINIMUMPERIOD
+#define DIMSTATISTICSMINIMUMPERIOD 500000000ULL /* ns, statistics records read in between share one update */
+#endif
+
+#ifndef DIMSERVICEGROUP
+#define DIMSERVICEGROUP 'g' /* @Sg=<group>[:<period s>]: served as one struct service */
+#endif
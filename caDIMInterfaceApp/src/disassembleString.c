@@ -419,3 +419,174 @@ void  safeFreeOfDisassemblyStringArrays(int found_elements, char*** keyArray, ch
 	*formatArray = NULL;
 
 }
+
+int tokenizeLink(const char input[], linkToken tokens[], int maxTokens,
+                 char primaryToken,
+                 char secondaryToken,
+                 char thirdToken,
+                 char spaceToken,
+                 char tokenProtection)
+{
+   /* tokenizeLink
+    *
+    * single pass, non allocating counterpart of disassembleString():
+    * splits input into elements `primaryToken key secondaryToken argument thirdToken format thirdToken'
+    * and returns them as slices of input in tokens (at most maxTokens),
+    * - tokens preceded by tokenProtection are not treated as tokens,
+    * - elements containing nothing but spaceToken are skipped,
+    * the slices still contain spaceToken and tokenProtection, s. copySlice()
+    *
+    * returns
+    *    -1 if error occur (no primaryToken/secondaryToken in input, more than maxTokens elements)
+    *    number of elements, else
+    */
+   enum { inKey, inArgument, inFormat, afterFormat } part = inKey;
+   const char *pCharacter = NULL;
+   bool content = false;
+   bool primaryFound = false;
+   bool secondaryFound = false;
+   int  found_elements = 0;
+
+   if (NULL == input || NULL == tokens || 0 >= maxTokens)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","tokenizeLink", "input string or tokens == NULL or no tokens\n");
+      return -1;
+   }
+
+   memset(&tokens[0], 0, sizeof(linkToken));
+   tokens[0].key.begin = input;
+
+   for (pCharacter = input; ; pCharacter++)
+   {
+      char character = *pCharacter;
+      linkToken *token = &tokens[found_elements];
+
+      /* protected token: part of the current slice */
+      if (0 < tokenProtection && tokenProtection == character && '\0' != pCharacter[1]
+          && (   primaryToken   == pCharacter[1] || secondaryToken == pCharacter[1]
+              || thirdToken     == pCharacter[1] || spaceToken     == pCharacter[1]))
+      {
+         content = true;
+         pCharacter++;
+         continue;
+      }
+
+      /* end of element */
+      if ('\0' == character || primaryToken == character)
+      {
+         primaryFound |= (primaryToken == character);
+         switch (part)
+         {
+         case inKey:
+            token->key.length = pCharacter - token->key.begin;
+            break;
+         case inArgument:
+            token->argument.length = pCharacter - token->argument.begin;
+            break;
+         case inFormat:
+            token->format.length = pCharacter - token->format.begin;
+            break;
+         default:
+            break;
+         }
+         if (true == content)
+         {
+            found_elements++;
+         }
+         if ('\0' == character)
+         {
+            break;
+         }
+         if (found_elements >= maxTokens)
+         {
+            message(stderr,__FILE__,__LINE__,"ERROR","tokenizeLink",
+                    "more than %i elements in `%s'\n", maxTokens, input);
+            return -1;
+         }
+         memset(&tokens[found_elements], 0, sizeof(linkToken));
+         tokens[found_elements].key.begin = pCharacter + 1;
+         part = inKey;
+         content = false;
+         continue;
+      }
+
+      if (spaceToken != character)
+      {
+         content = true;
+      }
+      secondaryFound |= (secondaryToken == character);
+
+      /* key=argument'format' */
+      if (inKey == part && secondaryToken == character)
+      {
+         token->key.length = pCharacter - token->key.begin;
+         token->argument.begin = pCharacter + 1;
+         part = inArgument;
+      }
+      else if (inArgument == part && thirdToken == character)
+      {
+         token->argument.length = pCharacter - token->argument.begin;
+         token->format.begin = pCharacter + 1;
+         part = inFormat;
+      }
+      else if (inFormat == part && thirdToken == character)
+      {
+         token->format.length = pCharacter - token->format.begin;
+         part = afterFormat;
+      }
+   }
+
+   if (false == primaryFound)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","tokenizeLink",
+              "\n\tstring `%s' \n\tdoesn't contain any key identifier (`%c') impossible to disassemble\n",
+              input, primaryToken);
+      return -1;
+   }
+   if (false == secondaryFound)
+   {
+      message(stderr,__FILE__,__LINE__,"ERROR","tokenizeLink",
+              " \n\tstring `%s' \n\tdoesn't contain any `%c' impossible to disassemble\n",
+              input, secondaryToken);
+      return -1;
+   }
+   return found_elements;
+}
+
+size_t copySlice(char output[], size_t size, stringSlice slice,
+                 char spaceToken,
+                 char tokenProtection,
+                 const char protectedTokens[])
+{
+   /* copySlice
+    *
+    * copies slice into output (size incl. terminating '\0'), 
+    * removing unprotected spaceToken and the tokenProtection in front of
+    * any of protectedTokens (or spaceToken), 
+    * returns the length of output
+    */
+   size_t length = 0;
+   size_t i = 0;
+
+   for (i = 0; i < slice.length && length+1 < size; i++)
+   {
+      char character = slice.begin[i];
+
+      if (0 < tokenProtection && tokenProtection == character && i+1 < slice.length
+          && (spaceToken == slice.begin[i+1] || NULL != strchr(protectedTokens, slice.begin[i+1])))
+      {
+         output[length++] = slice.begin[++i];
+         continue;
+      }
+      if (spaceToken == character)
+      {
+         continue;
+      }
+      output[length++] = character;
+   }
+   if (0 < size)
+   {
+      output[length] = '\0';
+   }
+   return length;
+}
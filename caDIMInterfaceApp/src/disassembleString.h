@@ -13,4 +13,30 @@ int     disassembleDIMFormatString(char format[], char ***typeArray, int **numbe
                                    char tokenProtection);
 void    safeFreeOfDisassemblyStringArrays(int found_elements, char*** keyArray, char*** argumentArray, char*** formatArray);
 
+/* slice of a string, not terminated, not owned */
+typedef struct stringSlice
+{
+   const char *begin;
+   size_t      length;
+} stringSlice;
+
+/* one `@key=argument'format' element of an INP/OUT string */
+typedef struct linkToken
+{
+   stringSlice key;
+   stringSlice argument;
+   stringSlice format;
+} linkToken;
+
+int     tokenizeLink(const char input[], linkToken tokens[], int maxTokens,
+                     char primaryToken,
+                     char secondaryToken,
+                     char thirdToken,
+                     char spaceToken,
+                     char tokenProtection);
+size_t  copySlice(char output[], size_t size, stringSlice slice,
+                  char spaceToken,
+                  char tokenProtection,
+                  const char protectedTokens[]);
+
 #endif /*DISASSEMBLESTRING_H_ */
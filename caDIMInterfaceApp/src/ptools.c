@@ -16,9 +16,231 @@
 #include <errno.h>
 #include <execinfo.h> /* for backtrace*/
 #include <limits.h>
+#include <pthread.h>
+#include <time.h>
 
 #include "ptools.h"
 
+/*
+ * asynchronous messages:
+ * message() formats into a slot of a ring buffer (multiple producers, lock free),
+ * a writer thread prints the slots in order,
+ * without the writer (not started, stopped) messages are printed directly,
+ * reports ("DUMP" and untyped) and messages too long for a slot are printed directly
+ * once the messages queued before them are out, so they keep their order
+ */
+#define MESSAGESLOTSIZE 512
+#define MESSAGERATELIMITSITES 256
+#define MESSAGERATELIMITDEFAULT 0 /* per second and call site, 0: unlimited */
+#define MESSAGEWRITERIDLE 10000000 /* ns */
+#define MESSAGEDRAINTIMEOUT 100 /* in MESSAGEWRITERIDLE/10, bounds the wait of a direct message */
+
+typedef struct messageSlot
+{
+   volatile size_t sequence;
+   FILE *stream;
+   char text[MESSAGESLOTSIZE];
+}
+messageSlot;
+
+typedef struct messageSite
+{
+   const char *file;
+   const char *fcn;
+   FILE *stream;
+   int line;
+   time_t second;
+   unsigned int count;
+   unsigned long suppressed;
+}
+messageSite;
+
+static struct messageSlot *messageRing = NULL;
+static size_t messageRingSize = 0;
+static volatile size_t messageEnqueuePosition = 0;
+static size_t messageDequeuePosition = 0;
+static volatile unsigned long messagesDropped = 0;
+static volatile int messageWriterRunning = 0;
+static volatile int messageProducers = 0;    /* callers between checking messageWriterRunning and enqueueing */
+static pthread_t messageWriter;
+static int messageThreshold = MESSAGE_DUMP;
+static unsigned int messageRateLimit = MESSAGERATELIMITDEFAULT;
+/* call sites, approximate: concurrent callers may miscount a little */
+static struct messageSite messageSites[MESSAGERATELIMITSITES];
+
+static int messageSeverityOf(const char* type)
+{
+   if (NULL == type)
+   {
+      return -1;
+   }
+   if (0 == strcmp(type, "ERROR"))
+   {
+      return MESSAGE_ERROR;
+   }
+   if (0 == strcmp(type, "WARNING"))
+   {
+      return MESSAGE_WARNING;
+   }
+   if (0 == strcmp(type, "INFO"))
+   {
+      return MESSAGE_INFO;
+   }
+   return MESSAGE_DUMP;
+}
+
+static bool enqueueMessage(FILE *stream, const char *text, size_t length)
+{
+   /* bounded queue, one sequence number per slot:
+    * == position: free, == position+1: written, the reader frees it for the next round
+    * full: the message is dropped (counted), the caller never waits
+    */
+   size_t position = messageEnqueuePosition;
+   struct messageSlot *slot = NULL;
+
+   for (;;)
+   {
+      long difference = 0;
+
+      slot = &messageRing[position & (messageRingSize - 1)];
+      difference = (long) slot->sequence - (long) position;
+      __sync_synchronize();
+      if (0 == difference)
+      {
+         if (__sync_bool_compare_and_swap(&messageEnqueuePosition, position, position + 1))
+         {
+            break;
+         }
+         position = messageEnqueuePosition;
+      }
+      else if (0 > difference)
+      {
+         __sync_fetch_and_add(&messagesDropped, 1);
+         return true;
+      }
+      else
+      {
+         position = messageEnqueuePosition;
+      }
+   }
+
+   slot->stream = stream;
+   memcpy(slot->text, text, length + 1);
+   __sync_synchronize();
+   slot->sequence = position + 1;
+   return true;
+}
+
+static void waitForMessageQueue(void)
+{
+   /* until the writer thread has printed the messages queued so far (bounded),
+    * not on the writer thread itself */
+   struct timespec idle = {0, MESSAGEWRITERIDLE / 10};
+   size_t position = messageEnqueuePosition;
+   int i = 0;
+
+   if (0 == messageWriterRunning || pthread_equal(pthread_self(), messageWriter))
+   {
+      return;
+   }
+   for (i = 0; i < MESSAGEDRAINTIMEOUT && 0 != messageWriterRunning && (long) (position - messageDequeuePosition) > 0; i++)
+   {
+      nanosleep(&idle, NULL);
+   }
+}
+
+static void emitMessage(FILE *stream, const char *text, size_t length, bool direct)
+{
+   /* messageProducers: stopMessageLogger() waits for enqueueing callers before releasing the ring,
+    * direct messages wait for the queued ones to keep the order */
+   if (false == direct && length < MESSAGESLOTSIZE)
+   {
+      __sync_fetch_and_add(&messageProducers, 1);
+      if (0 != messageWriterRunning)
+      {
+         enqueueMessage(stream, text, length);
+         __sync_fetch_and_sub(&messageProducers, 1);
+         return;
+      }
+      __sync_fetch_and_sub(&messageProducers, 1);
+   }
+   waitForMessageQueue();
+   fputs(text, stream);
+   fflush(stream);
+}
+
+static void reportSuppressedMessage(struct messageSite *site)
+{
+   char text[MESSAGESLOTSIZE];
+   int length = snprintf(text, sizeof(text), "WARNING in message(): %lu message(s) of %s(), LINE %i suppressed\n",
+                         site->suppressed, site->fcn ? site->fcn : "?", site->line);
+
+   emitMessage(site->stream ? site->stream : stderr, text, (0 < length && length < (int) sizeof(text)) ? length : 0, false);
+   site->suppressed = 0;
+}
+
+static void reportSuppressedMessages(bool all)
+{
+   /* suppressed messages of call sites not heard of since (all: of every call site) */
+   time_t now = time(NULL);
+   int i = 0;
+
+   for (i = 0; i < MESSAGERATELIMITSITES; i++)
+   {
+      if (0 < messageSites[i].suppressed && (true == all || messageSites[i].second != now))
+      {
+         reportSuppressedMessage(&messageSites[i]);
+      }
+   }
+}
+
+static bool messageRateAllowed(FILE *stream, const char *file, int line, const char *fcn)
+{
+   /* at most messageRateLimit messages per second and call site (file, line, function),
+    * the number suppressed is reported with the first message of a later second,
+    * by the writer thread when idle or at stopMessageLogger() */
+   size_t hash = ((size_t) file ^ ((size_t) fcn * 31) ^ ((size_t) line * 2654435761u)) % MESSAGERATELIMITSITES;
+   struct messageSite *site = &messageSites[hash];
+   time_t now = 0;
+
+   if (0 == messageRateLimit)
+   {
+      return true;
+   }
+   now = time(NULL);
+   if (site->file != file || site->fcn != fcn || site->line != line)
+   {
+      if (0 < site->suppressed)
+      {
+         reportSuppressedMessage(site);
+      }
+      site->file = file;
+      site->fcn = fcn;
+      site->line = line;
+      site->stream = stream;
+      site->second = now;
+      site->count = 0;
+      site->suppressed = 0;
+   }
+   if (site->second != now)
+   {
+      if (0 < site->suppressed)
+      {
+         reportSuppressedMessage(site);
+      }
+      site->second = now;
+      site->count = 0;
+      site->suppressed = 0;
+   }
+   if (site->count >= messageRateLimit)
+   {
+      site->suppressed++;
+      return false;
+   }
+   site->count++;
+   return true;
+}
+
 void message(FILE *stream, const char *file, int line, const char* type, const char* fcn, const char* format, ...)
 {
    /* prints message to stream,
@@ -27,44 +249,229 @@ void message(FILE *stream, const char *file, int line, const char* type, const c
     * 
     * in addition line message type and functionname are added in front of the message given in format and ...
     * if fcn is set to NULL / 0 its content is ommitted.
+    *
+    * the message is formatted at once and handed to the writer thread (s. startMessageLogger()),
+    * reports ("DUMP" and messages without type) are printed directly, after the messages queued before,
+    * messages below the threshold are skipped, "INFO" and "WARNING" are rate limited (s. setMessageRateLimit())
     */
-
+   char text[MESSAGESLOTSIZE];
+   char *output = text;
+   int severity = messageSeverityOf(type);
+   int length = 0;
+   int prefixLength = 0;
    va_list argumentPointer;
-   va_start(argumentPointer, format);
 
+   if (0 <= severity && severity < messageThreshold)
+   {
+      return;
+   }
+   if (MESSAGE_DUMP < severity && MESSAGE_ERROR > severity && false == messageRateAllowed(stream, file, line, fcn))
+   {
+      return;
+   }
+
+   text[0] = '\0';
    if (NULL != type)
    {
-      fprintf(stream,"%s",type);
+      prefixLength += snprintf(text + prefixLength, sizeof(text) - prefixLength, "%s", type);
    }
    if (0 < line)
    {
-      fprintf(stream," in LINE %5i",line);
+      prefixLength += snprintf(text + prefixLength, sizeof(text) - prefixLength, " in LINE %5i", line);
    }
    if (NULL != file)
    {
-      fprintf(stream," of FILE %s",file);
+      prefixLength += snprintf(text + prefixLength, sizeof(text) - prefixLength, " of FILE %s", file);
    }
    if ( NULL != fcn)
    {
-      fprintf(stream," in %s(): ",fcn);
+      prefixLength += snprintf(text + prefixLength, sizeof(text) - prefixLength, " in %s(): ", fcn);
    }
    else
    {
       if ( NULL != type || 0 < line || NULL != file || NULL != fcn)
       {
-         fprintf(stream,": ");
+         prefixLength += snprintf(text + prefixLength, sizeof(text) - prefixLength, ": ");
       }
    }
-   if ( 0 > vfprintf(stream, format, argumentPointer))
+   if (prefixLength >= (int) sizeof(text))
    {
-      fprintf(stream,"LINE %5i - %s in %s()",__LINE__+1, "ERROR", "message");
-      fprintf(stream,"call of vfprintf() failed\n");
+      prefixLength = sizeof(text) - 1;
    }
-   fflush(stream);
+
+   va_start(argumentPointer, format);
+   length = vsnprintf(text + prefixLength, sizeof(text) - prefixLength, format, argumentPointer);
    va_end(argumentPointer);
+   if (0 > length)
+   {
+      snprintf(text, sizeof(text), "LINE %5i - %s in %s()call of vfprintf() failed\n", __LINE__, "ERROR", "message");
+      emitMessage(stream, text, strlen(text), true);
+      return;
+   }
+   length += prefixLength;
+
+   /* too long for a slot: formatted again on the heap, printed directly */
+   if (length >= (int) sizeof(text))
+   {
+      output = (char*) malloc(length + 1);
+      if (NULL == output)
+      {
+         emitMessage(stream, text, strlen(text), true);
+         return;
+      }
+      memcpy(output, text, prefixLength);
+      va_start(argumentPointer, format);
+      vsnprintf(output + prefixLength, length + 1 - prefixLength, format, argumentPointer);
+      va_end(argumentPointer);
+   }
+
+   emitMessage(stream, output, length, (MESSAGE_DUMP >= severity));
+   if (output != text)
+   {
+      free(output);
+   }
    return;
 }
 
+static size_t writeMessages(void)
+{
+   /* prints all slots written so far, in order */
+   size_t written = 0;
+   unsigned long dropped = 0;
+
+   for (;;)
+   {
+      struct messageSlot *slot = &messageRing[messageDequeuePosition & (messageRingSize - 1)];
+
+      if (slot->sequence != messageDequeuePosition + 1)
+      {
+         break;
+      }
+      __sync_synchronize();
+      fputs(slot->text, slot->stream);
+      __sync_synchronize();
+      slot->sequence = messageDequeuePosition + messageRingSize;
+      messageDequeuePosition++;
+      written++;
+   }
+
+   dropped = __sync_fetch_and_and(&messagesDropped, 0);
+   if (0 < dropped)
+   {
+      fprintf(stderr, "WARNING in message(): %lu message(s) dropped, buffer full\n", dropped);
+   }
+   if (0 < written || 0 < dropped)
+   {
+      fflush(NULL);
+   }
+   return written;
+}
+
+static void* messageWriterThread(void *arg)
+{
+   struct timespec idle = {0, MESSAGEWRITERIDLE};
+
+   while (0 != messageWriterRunning)
+   {
+      if (0 == writeMessages())
+      {
+         reportSuppressedMessages(false);
+         nanosleep(&idle, NULL);
+      }
+   }
+   writeMessages();
+   return NULL;
+}
+
+bool startMessageLogger(size_t numberOfSlots)
+{
+   /* ring of numberOfSlots (rounded up to a power of 2) messages and its writer thread */
+   size_t i = 0;
+   size_t size = 1;
+
+   if (0 != messageWriterRunning)
+   {
+      return true;
+   }
+   while (size < numberOfSlots)
+   {
+      size <<= 1;
+   }
+   messageRing = (struct messageSlot*) calloc(size, sizeof(struct messageSlot));
+   if (NULL == messageRing)
+   {
+      message(stderr, __FILE__, __LINE__, "ERROR", "startMessageLogger", "couldn't allocate memory\n");
+      return false;
+   }
+   for (i = 0; i < size; i++)
+   {
+      messageRing[i].sequence = i;
+   }
+   messageRingSize = size;
+   messageEnqueuePosition = 0;
+   messageDequeuePosition = 0;
+
+   messageWriterRunning = 1;
+   __sync_synchronize();
+   if (0 != pthread_create(&messageWriter, NULL, messageWriterThread, NULL))
+   {
+      messageWriterRunning = 0;
+      SAFE_FREE(messageRing);
+      message(stderr, __FILE__, __LINE__, "ERROR", "startMessageLogger", "couldn't create writer thread\n");
+      return false;
+   }
+   return true;
+}
+
+void stopMessageLogger(void)
+{
+   /* prints the messages still queued and the suppressed counts, afterwards messages are printed directly,
+    * the ring is released, startMessageLogger() may be called again */
+   struct timespec idle = {0, MESSAGEWRITERIDLE / 10};
+
+   if (0 == messageWriterRunning)
+   {
+      return;
+   }
+   messageWriterRunning = 0;
+   __sync_synchronize();
+   pthread_join(messageWriter, NULL);
+   /* callers that saw the writer running are still enqueueing */
+   while (0 != messageProducers)
+   {
+      nanosleep(&idle, NULL);
+   }
+   __sync_synchronize();
+   writeMessages();
+   reportSuppressedMessages(true);
+
+   SAFE_FREE(messageRing);
+   messageRingSize = 0;
+   messageEnqueuePosition = 0;
+   messageDequeuePosition = 0;
+}
+
+void setMessageThreshold(int severity)
+{
+   /* messages below severity are skipped, messages without type are always printed */
+   messageThreshold = severity;
+}
+
+void setMessageRateLimit(unsigned int messagesPerSecond)
+{
+   /* "INFO" and "WARNING" messages per second and call site, 0: unlimited, "ERROR" is never limited */
+   messageRateLimit = messagesPerSecond;
+}
+
+size_t messageQueueDepth(void)
+{
+   /* messages waiting for the writer thread, approximate */
+   size_t enqueued = messageEnqueuePosition;
+   size_t dequeued = messageDequeuePosition;
+
+   return (enqueued > dequeued) ? enqueued - dequeued : 0;
+}
+
 void backTrace(size_t level)
 {
    /*
@@ -1337,6 +1744,210 @@ bool removeFromStack(struct stack* pStack, void* element, int (*compare)(void*,v
    return false;
 }
 
+/* mailbox implementation */
+
+bool initMailbox(struct mailbox* pMailbox, size_t capacity)
+{
+   /* single producer / single consumer mailbox holding the latest data written,
+    * protected by a sequence counter (seqlock):
+    * the producer never waits, the consumer retries until it read a consistent snapshot
+    */
+   if (NULL == pMailbox)
+   {
+      message(stderr, __FILE__, __LINE__, "ERROR", "initMailbox", "argument is NULL\n");
+      return false;
+   }
+   pMailbox->data = calloc(capacity ? capacity : 1, sizeof(char));
+   if (NULL == pMailbox->data)
+   {
+      message(stderr, __FILE__, __LINE__, "ERROR", "initMailbox", "couldn't allocate memory\n");
+      return false;
+   }
+   pMailbox->capacity = capacity;
+   pMailbox->size = 0;
+   pMailbox->sequence = 0;
+   return true;
+}
+
+void clearMailbox(struct mailbox* pMailbox)
+{
+   if (NULL != pMailbox)
+   {
+      SAFE_FREE(pMailbox->data);
+      pMailbox->capacity = 0;
+      pMailbox->size = 0;
+      pMailbox->sequence = 0;
+   }
+}
+
+unsigned int writeMailbox(struct mailbox* pMailbox, const void* data, size_t size)
+{
+   /* copies at most capacity bytes of data into the mailbox,
+    * returns the sequence number of the new content (always even)
+    */
+   unsigned int sequence = pMailbox->sequence;
+
+   if (size > pMailbox->capacity)
+   {
+      size = pMailbox->capacity;
+   }
+
+   /* odd: write in progress */
+   pMailbox->sequence = sequence + 1;
+   __sync_synchronize();
+
+   memcpy(pMailbox->data, data, size);
+   pMailbox->size = size;
+
+   __sync_synchronize();
+   pMailbox->sequence = sequence + 2;
+
+   return sequence + 2;
+}
+
+size_t readMailbox(struct mailbox* pMailbox, void* data, size_t capacity, unsigned int *sequence)
+{
+   /* copies a consistent snapshot of the mailbox's content to data (at most capacity bytes),
+    * returns the number of bytes copied,
+    * if sequence is not NULL the sequence number of the snapshot is stored there
+    */
+   unsigned int begin = 0;
+   unsigned int end = 0;
+   size_t size = 0;
+
+   do
+   {
+      begin = pMailbox->sequence;
+      if (begin & 1)
+      {
+         /* producer is writing */
+         continue;
+      }
+      __sync_synchronize();
+
+      size = pMailbox->size;
+      if (size > capacity)
+      {
+         size = capacity;
+      }
+      memcpy(data, pMailbox->data, size);
+
+      __sync_synchronize();
+      end = pMailbox->sequence;
+   }
+   while ((begin & 1) || begin != end);
+
+   if (NULL != sequence)
+   {
+      *sequence = begin;
+   }
+   return size;
+}
+
+/* arena implementation */
+
+#ifndef ARENA_ALIGNMENT
+#define ARENA_ALIGNMENT 8
+#endif
+
+static struct arenaBlock* newArenaBlock(size_t capacity)
+{
+   struct arenaBlock *pBlock = (struct arenaBlock*) malloc(sizeof(struct arenaBlock) + capacity);
+   if (NULL == pBlock)
+   {
+      message(stderr, __FILE__, __LINE__, "ERROR", "newArenaBlock", "couldn't allocate memory\n");
+      return NULL;
+   }
+   pBlock->next = NULL;
+   pBlock->capacity = capacity;
+   pBlock->used = 0;
+   return pBlock;
+}
+
+bool initArena(struct arena* pArena, size_t blockSize)
+{
+   /* memory living as long as the arena:
+    * allocations are taken in order from blocks of blockSize bytes,
+    * a new block is chained when the current one is full,
+    * nothing is freed but everything at once by clearArena(),
+    * not thread safe
+    */
+   if (NULL == pArena)
+   {
+      message(stderr, __FILE__, __LINE__, "ERROR", "initArena", "argument is NULL\n");
+      return false;
+   }
+   pArena->blockSize = blockSize ? blockSize : 4096;
+   pArena->first = newArenaBlock(pArena->blockSize);
+   pArena->current = pArena->first;
+   pArena->allocated = 0;
+   pArena->allocations = 0;
+   return (NULL != pArena->first);
+}
+
+void* arenaAlloc(struct arena* pArena, size_t size)
+{
+   /* returns size bytes, zeroed and aligned to ARENA_ALIGNMENT, or NULL */
+   void *pointer = NULL;
+   size_t aligned = (size + ARENA_ALIGNMENT - 1) & ~((size_t) ARENA_ALIGNMENT - 1);
+
+   if (NULL == pArena || NULL == pArena->current)
+   {
+      message(stderr, __FILE__, __LINE__, "ERROR", "arenaAlloc", "arena not initialised\n");
+      return NULL;
+   }
+   if (aligned > pArena->current->capacity - pArena->current->used)
+   {
+      struct arenaBlock *pBlock = newArenaBlock(aligned > pArena->blockSize ? aligned : pArena->blockSize);
+      if (NULL == pBlock)
+      {
+         return NULL;
+      }
+      pArena->current->next = pBlock;
+      pArena->current = pBlock;
+   }
+   pointer = (char*)(pArena->current + 1) + pArena->current->used;
+   pArena->current->used += aligned;
+   pArena->allocated += aligned;
+   pArena->allocations++;
+   memset(pointer, 0, size);
+   return pointer;
+}
+
+char* arenaStrdup(struct arena* pArena, const char* string)
+{
+   char *copy = NULL;
+   if (NULL == string)
+   {
+      return NULL;
+   }
+   copy = (char*) arenaAlloc(pArena, strlen(string) + 1);
+   if (NULL != copy)
+   {
+      strcpy(copy, string);
+   }
+   return copy;
+}
+
+void clearArena(struct arena* pArena)
+{
+   /* releases all blocks, every pointer taken from the arena becomes invalid */
+   struct arenaBlock *pBlock = NULL;
+   if (NULL == pArena)
+   {
+      return;
+   }
+   while (NULL != pArena->first)
+   {
+      pBlock = pArena->first;
+      pArena->first = pBlock->next;
+      free(pBlock);
+   }
+   pArena->current = NULL;
+   pArena->allocated = 0;
+   pArena->allocations = 0;
+}
+
 /* double linked list implementation */
 
 #ifdef INCLUDELIST
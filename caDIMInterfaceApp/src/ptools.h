@@ -25,7 +25,20 @@ int     replaceStringlets(char* input, char **output, char* token, char* replace
 int     combineString(char **list, char** output, size_t elements);
 
 /* messages */
+typedef enum
+{
+   MESSAGE_DUMP      /* "DUMP" and any other type */
+   ,MESSAGE_INFO
+   ,MESSAGE_WARNING
+   ,MESSAGE_ERROR
+} messageSeverity;
+
 void    message(FILE *stream, const char *file, int line, const char* type, const char* fcn, const char* format, ...);
+bool    startMessageLogger(size_t numberOfSlots);
+void    stopMessageLogger(void);
+void    setMessageThreshold(int severity);
+void    setMessageRateLimit(unsigned int messagesPerSecond);
+size_t  messageQueueDepth(void);
 
 /* debugging */
 void    backTrace(size_t level);
@@ -62,6 +75,44 @@ bool dumpStackString(FILE *stream, struct stack* pStack);
 bool removeFromStack(struct stack* pStack, void* element, int (*compare)(void*,void*));
 void* findInStack(struct stack* pStack, void* element, int (*compare)(void*,void*));
 
+/*mailbox*/
+typedef struct mailbox
+{
+   void* data;
+   size_t capacity;
+   volatile size_t size;
+   volatile unsigned int sequence;
+}
+mailbox;
+
+bool initMailbox(struct mailbox* pMailbox, size_t capacity);
+void clearMailbox(struct mailbox* pMailbox);
+unsigned int writeMailbox(struct mailbox* pMailbox, const void* data, size_t size);
+size_t readMailbox(struct mailbox* pMailbox, void* data, size_t capacity, unsigned int *sequence);
+
+/*arena*/
+typedef struct arenaBlock
+{
+   struct arenaBlock* next;
+   size_t capacity;
+   size_t used;
+}
+arenaBlock;
+
+typedef struct arena
+{
+   struct arenaBlock *first;
+   struct arenaBlock *current;
+   size_t blockSize;
+   size_t allocated;
+   size_t allocations;
+}
+arena;
+
+bool initArena(struct arena* pArena, size_t blockSize);
+void* arenaAlloc(struct arena* pArena, size_t size);
+char* arenaStrdup(struct arena* pArena, const char* string);
+void clearArena(struct arena* pArena);
 
 /*list*/
 #ifdef INCLUDELIST
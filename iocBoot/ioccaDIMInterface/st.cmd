@@ -11,6 +11,19 @@ cd ${TOP}
 dbLoadDatabase("dbd/caDIMInterface.dbd")
 caDIMInterface_registerRecordDeviceDriver(pdbbase)
 
+## Cache of the formats of client services without @Sf/@Cf (node service format),
+## read before the records are initialised, refreshed in the background after iocInit
+#dimSetFormatCache("${TOP}/iocBoot/${IOC}/dimFormat.cache")
+
+## Output per record while the records are initialised:
+## 0: none, 1: one line (default), 2: all fields, single records later with dimDumpRecord("<name>")
+#var dimVerbosity 1
+
+## Messages of the device support: skip those below a severity (0: all, 1: INFO, 2: WARNING, 3: ERROR),
+## at most n INFO/WARNING messages per second and call site (0: unlimited, the default)
+#dimMessageThreshold 1
+#dimMessageRateLimit 10
+
 ## Load record instances
 
 #dbLoadRecords("db/dbDIMInterface.db","any=, record=ai, INPOUT=INP, user=$(USER), pvName=ServerSvcCmd2,  value=112, Type=@T\=S, serviceName=@S\=Jeder1, serviceFormat=, commandName=@C\=Man, commandFormat=, serverName=@N\=MyIOC-II, dnsAddress=, dnsPort=, defaultPut=, defaultGet=, scanMode=, scanInterval=, scanPeriod=Passive, precision=2")
@@ -22,8 +35,20 @@ dbLoadRecords("db/dbDIMInterface.db", "any=, record=ai, INPOUT=INP, user=$(USER)
 dbLoadRecords("db/dbDIMInterface.db", "any=, record=ai, INPOUT=INP, user=$(USER), pvName=IntValClient,    value=0,   Type=@T\=C, serviceName=@S\=TEST/INTVAL,    serviceFormat=@Sf\=I:1, commandName=,                     commandFormat=,         serverName=, dnsAddress=, dnsPort=, defaultPut=, defaultGet=, scanMode=, scanInterval=, scanPeriod=Passive, precision=0")
 dbLoadRecords("db/dbDIMInterface.db", "any=, record=ai, INPOUT=INP, user=$(USER), pvName=KillTestServer,  value=0,   Type=@T\=C, serviceName=,                   serviceFormat=,         commandName=@C\=TEST-SERVER/EXIT, commandFormat=@Cf\=L:1, serverName=, dnsAddress=, dnsPort=, defaultPut=, defaultGet=, scanMode=, scanInterval=, scanPeriod=Passive, precision=2")
 
+#example for a client service processed on the EPICS callback threads (SCAN="I/O Intr")
+#dbLoadRecords("db/dbDIMInterface.db", "any=, record=ai, INPOUT=INP, user=$(USER), pvName=DoubleValClientIoIntr, value=100, Type=@T\=C, serviceName=@S\=TEST/DOUBLEVAL, serviceFormat=@Sf\=D:1, commandName=,                     commandFormat=,         serverName=, dnsAddress=, dnsPort=, defaultPut=, defaultGet=, scanMode=, scanInterval=, scanPeriod=I/O Intr, precision=2")
+
 dbLoadRecords("db/dbDIMInterface.db", "any=, record=ao, INPOUT=OUT, user=$(USER), pvName=ServerAo,  value=10,   Type=@T\=S, serviceName=, serviceFormat=, commandName=, commandFormat=, serverName=, dnsAddress=, dnsPort=, defaultPut=, defaultGet=, scanMode=, scanInterval=, scanPeriod=Passive, precision=2")
 
+#examples for waveforms: a server publishing 16 floats and a client command sending them back (NORD elements, FTVL fixes the EPICS type)
+#dbLoadRecords("db/dbDIMInterfaceWaveform.db", "any=, user=$(USER), pvName=ServerWaveform, Type=@T\=S, serviceName=@S\=TEST/WAVEFORM, serviceFormat=@Sf\=F:16, commandName=, commandFormat=, serverName=, dnsAddress=, dnsPort=, defaultPut=, defaultGet=, scanMode=, scanInterval=, scanPeriod=Passive, ftvl=FLOAT, nelm=16")
+#same, published directly from the waveform's array without a copy (@Xz)
+#dbLoadRecords("db/dbDIMInterfaceWaveform.db", "any=@Xz, user=$(USER), pvName=ServerWaveformZeroCopy, Type=@T\=S, serviceName=@S\=TEST/WAVEFORMZEROCOPY, serviceFormat=@Sf\=F:16, commandName=, commandFormat=, serverName=, dnsAddress=, dnsPort=, defaultPut=, defaultGet=, scanMode=, scanInterval=, scanPeriod=Passive, ftvl=FLOAT, nelm=16")
+#dbLoadRecords("db/dbDIMInterfaceWaveform.db", "any=, user=$(USER), pvName=ClientWaveformCmd, Type=@T\=C, serviceName=, serviceFormat=, commandName=@C\=TEST/WAVEFORMCMD, commandFormat=@Cf\=F:16, serverName=, dnsAddress=, dnsPort=, defaultPut=, defaultGet=, scanMode=, scanInterval=, scanPeriod=Passive, ftvl=FLOAT, nelm=16")
+
+
+## driver statistics (callback rate, latency percentiles, queues, disconnects, failed commands)
+#dbLoadRecords("db/dbDIMStatistics.db", "P=$(USER):DIM, SCAN=1 second")
 
 ## Set this to see messages from mySub
 #var mySubDebug 1